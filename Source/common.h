@@ -16,6 +16,8 @@
 #include "clang/AST/Comment.h"
 
 #include <fstream>
+#include <map>
+#include <set>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -41,6 +43,17 @@ extern std::string sFrameworkExportMacro;
 extern std::string sEditorExportMacro;
 extern std::string sFrameworkCopyrightNotice;
 extern std::string sEditorCopyrightNotice;
+extern bool sReportIncludes;
+extern int sNumSourceShards;
+extern int sUnityBuildSize;
+extern std::vector<std::string> sUnityExcludedModules;
+extern bool sGenerateBinaryInfo;
+extern bool sDryRun;
+extern bool sGenerateCallBenchmark;
+extern bool sPoolWrapperAllocations;
+extern bool sLazyRuntimeData;
+extern std::string sCostReportPath;
+extern std::string sCostBaselinePath;
 
 enum class ParsedType
 {
@@ -82,7 +95,8 @@ enum class TypeFlags
 	ComponentOrActor = 1 << 18,
 	Path = 1 << 19,
 	AsyncOp = 1 << 20,
-	SmallVector = 1 << 21
+	SmallVector = 1 << 21,
+	Span = 1 << 22
 };
 
 enum class MethodFlags
@@ -96,6 +110,11 @@ enum class MethodFlags
 	Callback = 1 << 6,
 	FieldWrapper = 1 << 7,
 	CSOnly = 1 << 8,
+	FillsBuffer = 1 << 9,
+	Batched = 1 << 10,
+	BatchCall = 1 << 11,
+	Deferred = 1 << 12,
+	Coalesced = 1 << 13
 };
 
 enum class CSVisibility
@@ -116,7 +135,10 @@ enum class ExportFlags
 	InteropOnly = 1 << 6,
 	ApiBSF = 1 << 7,
 	ApiB3D = 1 << 8,
-	ApiBED = 1 << 9
+	ApiBED = 1 << 9,
+	Batched = 1 << 10,
+	Deferred = 1 << 11,
+	Coalesced = 1 << 12
 };
 
 enum class ClassFlags
@@ -236,6 +258,11 @@ struct FieldInfo : VarInfo
 {
 	CommentEntry documentation;
 	Style style;
+
+	// Native memory layout, in bytes. Offset is -1 if the layout is not known.
+	int offset = -1;
+	int size = 0;
+	int alignment = 0;
 };
 
 struct TemplateParamInfo
@@ -324,6 +351,7 @@ struct StructInfo
 	std::vector<FieldInfo> fields;
 	bool requiresInterop : 1;
 	bool isTemplateInst : 1;
+	bool isStruct : 1;
 
 	CommentEntry documentation;
 	std::string module;
@@ -346,7 +374,7 @@ struct EnumInfo
 	SmallVector<std::string, 4> ns;
 
 	std::string explicitType;
-	std::unordered_map<int, EnumEntryInfo> entries;
+	std::map<int, EnumEntryInfo> entries;
 
 	CommentEntry documentation;
 	std::string module;
@@ -363,20 +391,13 @@ struct ForwardDeclInfo
 	{
 		return name == rhs.name && ns == rhs.ns;
 	}
-};
 
-template<>
-struct std::hash<ForwardDeclInfo>
-{
-	std::size_t operator()(const ForwardDeclInfo& value) const
+	bool operator<(const ForwardDeclInfo& rhs) const
 	{
-		std::hash<std::string> hasher;
-		size_t hash = hasher(value.name);
+		if (ns != rhs.ns)
+			return ns < rhs.ns;
 
-		for (auto& entry : value.ns)
-			hash = hash_combine(hash, hasher(entry));
-		
-		return hash;
+		return name < rhs.name;
 	}
 };
 
@@ -386,7 +407,7 @@ struct FileInfo
 	std::vector<StructInfo> structInfos;
 	std::vector<EnumInfo> enumInfos;
 
-	std::unordered_set<ForwardDeclInfo> forwardDeclarations;
+	std::set<ForwardDeclInfo> forwardDeclarations;
 	std::vector<std::string> referencedHeaderIncludes;
 	std::vector<std::string> referencedSourceIncludes;
 	bool inEditor;
@@ -424,8 +445,8 @@ struct IncludesInfo
 	bool requiresRRef = false;
 	bool requiresRTTI = false;
 	bool requiresAsyncOp = false;
-	std::unordered_map<std::string, IncludeInfo> includes;
-	std::unordered_map<std::string, ForwardDeclInfo> fwdDecls;
+	std::map<std::string, IncludeInfo> includes;
+	std::map<std::string, ForwardDeclInfo> fwdDecls;
 };
 
 struct CommentMethodInfo
@@ -446,9 +467,180 @@ struct CommentInfo
 	bool isFunction;
 };
 
-struct BaseClassInfo
+/** 
+ * Compact representation of the hierarchy of exported classes. Classes are assigned dense IDs and numbered in depth-first
+ * order, so all classes deriving from a class form a contiguous range.
+ */
+class ClassHierarchy
 {
-	std::vector<std::string> childClasses;
+public:
+	/** Registers a class deriving from the provided base class. build() must be called before querying the hierarchy. */
+	void addDerivedClass(const std::string& baseClass, const std::string& derivedClass)
+	{
+		int baseId = getOrCreateId(baseClass);
+		int derivedId = getOrCreateId(derivedClass);
+
+		if (parents[derivedId] != -1)
+			return;
+
+		parents[derivedId] = baseId;
+		edges.push_back(std::make_pair(baseId, derivedId));
+	}
+
+	/** Flattens the child lists and numbers all the classes in depth-first order. */
+	void build()
+	{
+		int numClasses = (int)names.size();
+
+		// Flatten child lists, keeping the children in the order they were registered in
+		childOffsets.assign(numClasses + 1, 0);
+		for (auto& entry : edges)
+			childOffsets[entry.first + 1]++;
+
+		for (int i = 0; i < numClasses; i++)
+			childOffsets[i + 1] += childOffsets[i];
+
+		children.resize(edges.size());
+		std::vector<int> insertIndices(childOffsets.begin(), childOffsets.end() - 1);
+		for (auto& entry : edges)
+			children[insertIndices[entry.first]++] = entry.second;
+
+		edges.clear();
+
+		// Number the classes in depth-first order, starting from the root classes
+		orderedNames.clear();
+		dfsIndices.assign(numClasses, -1);
+		descendantCounts.assign(numClasses, 0);
+
+		SmallVector<std::pair<int, int>, 16> todo;
+		auto visit = [this, &todo](int id)
+		{
+			dfsIndices[id] = (int)orderedNames.size();
+			orderedNames.push_back(names[id]);
+			todo.push_back(std::make_pair(id, childOffsets[id]));
+		};
+
+		for (int i = 0; i < numClasses; i++)
+		{
+			if (parents[i] != -1)
+				continue;
+
+			visit(i);
+			while (!todo.empty())
+			{
+				int id = todo.back().first;
+				int childIdx = todo.back().second;
+
+				if (childIdx < childOffsets[id + 1])
+				{
+					todo.back().second++;
+					visit(children[childIdx]);
+				}
+				else
+				{
+					descendantCounts[id] = (int)orderedNames.size() - dfsIndices[id] - 1;
+					todo.pop_back();
+				}
+			}
+		}
+	}
+
+	/** Returns names of all classes deriving from the provided class, in depth-first order. */
+	ArrayRef<std::string> getDerivedClasses(const std::string& name) const
+	{
+		auto iterFind = ids.find(name);
+		if (iterFind == ids.end())
+			return ArrayRef<std::string>();
+
+		int id = iterFind->second;
+		if (dfsIndices[id] == -1)
+			return ArrayRef<std::string>();
+
+		return ArrayRef<std::string>(orderedNames).slice(dfsIndices[id] + 1, descendantCounts[id]);
+	}
+
+	/** Checks if any classes derive from the provided class. */
+	bool isBase(const std::string& name) const
+	{
+		auto iterFind = ids.find(name);
+		if (iterFind == ids.end())
+			return false;
+
+		int id = iterFind->second;
+		return childOffsets[id + 1] != childOffsets[id];
+	}
+
+private:
+	int getOrCreateId(const std::string& name)
+	{
+		auto iterFind = ids.find(name);
+		if (iterFind != ids.end())
+			return iterFind->second;
+
+		int id = (int)names.size();
+		ids[name] = id;
+		names.push_back(name);
+		parents.push_back(-1);
+
+		return id;
+	}
+
+	std::unordered_map<std::string, int> ids;
+	std::vector<std::string> names;
+	std::vector<int> parents;
+	std::vector<std::pair<int, int>> edges;
+
+	std::vector<int> childOffsets;
+	std::vector<int> children;
+
+	std::vector<std::string> orderedNames;
+	std::vector<int> dfsIndices;
+	std::vector<int> descendantCounts;
+};
+
+/** 
+ * Accumulates generated code in a single growable buffer. Generator functions append to the writer they are provided
+ * with, and the contents are written to disk once the file is complete.
+ */
+class CodeWriter
+{
+public:
+	explicit CodeWriter(size_t reserveSize = 4096)
+	{
+		buffer.reserve(reserveSize);
+	}
+
+	CodeWriter& operator<<(const std::string& value) { buffer.append(value); return *this; }
+	CodeWriter& operator<<(StringRef value) { buffer.append(value.data(), value.size()); return *this; }
+	CodeWriter& operator<<(const char* value) { buffer.append(value); return *this; }
+	CodeWriter& operator<<(char value) { buffer.push_back(value); return *this; }
+	CodeWriter& operator<<(const CodeWriter& value) { buffer.append(value.buffer); return *this; }
+
+	CodeWriter& operator<<(int value) { buffer.append(std::to_string(value)); return *this; }
+	CodeWriter& operator<<(unsigned int value) { buffer.append(std::to_string(value)); return *this; }
+	CodeWriter& operator<<(long value) { buffer.append(std::to_string(value)); return *this; }
+	CodeWriter& operator<<(unsigned long value) { buffer.append(std::to_string(value)); return *this; }
+	CodeWriter& operator<<(long long value) { buffer.append(std::to_string(value)); return *this; }
+	CodeWriter& operator<<(unsigned long long value) { buffer.append(std::to_string(value)); return *this; }
+
+	// Note: Same formatting as the default std::ostream formatting
+	CodeWriter& operator<<(double value)
+	{
+		char output[32];
+		int length = snprintf(output, sizeof(output), "%g", value);
+		buffer.append(output, length);
+
+		return *this;
+	}
+
+	const std::string& str() const { return buffer; }
+	const char* data() const { return buffer.data(); }
+	size_t size() const { return buffer.size(); }
+	bool empty() const { return buffer.empty(); }
+	void clear() { buffer.clear(); }
+
+private:
+	std::string buffer;
 };
 
 enum FileType
@@ -463,13 +655,24 @@ enum FileType
 };
 
 extern std::unordered_map<std::string, UserTypeInfo> cppToCsTypeMap;
-extern std::unordered_map<std::string, FileInfo> outputFileInfos;
+extern std::map<std::string, FileInfo> outputFileInfos;
 extern std::unordered_map<std::string, ExternalClassInfos> externalClassInfos;
-extern std::unordered_map<std::string, BaseClassInfo> baseClassLookup;
+extern ClassHierarchy classHierarchy;
 extern std::vector<CommentInfo> commentInfos;
 extern std::unordered_map<std::string, int> commentFullLookup;
 extern std::unordered_map<std::string, SmallVector<int, 2>> commentSimpleLookup;
 
+/** 
+ * Stream that type mapping diagnostics are written to on the current thread. Parallel passes redirect it to their 
+ * per-file log so diagnostics don't race or interleave between threads. When null, errs() is used.
+ */
+extern thread_local raw_ostream* sTypeMappingLog;
+
+inline raw_ostream& getTypeMappingLog()
+{
+	return sTypeMappingLog != nullptr ? *sTypeMappingLog : errs();
+}
+
 inline bool mapBuiltinTypeToCSType(BuiltinType::Kind kind, std::string& output)
 {
 	switch (kind)
@@ -536,7 +739,7 @@ inline bool mapBuiltinTypeToCSType(BuiltinType::Kind kind, std::string& output)
 		break;
 	}
 
-	errs() << "Unrecognized builtin type found.\n";
+	getTypeMappingLog() << "Unrecognized builtin type found.\n";
 	return false;
 }
 
@@ -652,7 +855,7 @@ inline bool mapBuiltinTypeToCppType(BuiltinType::Kind kind, std::string& output)
 		break;
 	}
 
-	errs() << "Unrecognized builtin type found.\n";
+	getTypeMappingLog() << "Unrecognized builtin type found.\n";
 	return false;
 }
 
@@ -726,7 +929,7 @@ inline UserTypeInfo getTypeInfo(const std::string& sourceType, int flags)
 				outType.scriptName = "RRefBase";
 				outType.type = ParsedType::Resource;
 
-				errs() << "Unable to map type \"" << sourceType << "\". Assuming generic resource.\n";
+				getTypeMappingLog() << "Unable to map type \"" << sourceType << "\". Assuming generic resource.\n";
 			}
 		}
 
@@ -752,7 +955,7 @@ inline UserTypeInfo getTypeInfo(const std::string& sourceType, int flags)
 			outType.scriptName = "AsyncOp<" + sourceType + ">";
 			outType.type = ParsedType::Class;
 
-			errs() << "Unable to map type \"" << sourceType << "\". Assuming same name as source. \n";
+			getTypeMappingLog() << "Unable to map type \"" << sourceType << "\". Assuming same name as source. \n";
 			return outType;
 		}
 	}
@@ -764,7 +967,7 @@ inline UserTypeInfo getTypeInfo(const std::string& sourceType, int flags)
 		outType.scriptName = mapCppTypeToCSType(sourceType);
 		outType.type = ParsedType::Builtin;
 
-		errs() << "Unable to map type \"" << sourceType << "\". Assuming same name as source.\n";
+		getTypeMappingLog() << "Unable to map type \"" << sourceType << "\". Assuming same name as source.\n";
 		return outType;
 	}
 
@@ -791,30 +994,44 @@ inline bool isValidAPI(ApiFlags api, bool editor)
    return (editor && hasAPIBED(api)) || (!editor && (hasAPIB3D(api) || hasAPIBSF(api)));
 }
 
-inline const std::string& escapeXML(const std::string& data) 
+/** String that gets escaped for use in XML when written to a CodeWriter. See escapeXML(). */
+struct XMLEscapedString
+{
+	const std::string& value;
+};
+
+/** 
+ * Escapes the provided string for use in XML, when the returned value is written to a CodeWriter. Escaped characters are 
+ * written directly into the writer, without any shared intermediate buffers, so it is safe to use from multiple threads. 
+ */
+inline XMLEscapedString escapeXML(const std::string& data)
+{
+	return { data };
+}
+
+inline CodeWriter& operator<<(CodeWriter& output, const XMLEscapedString& input)
 {
+	const std::string& data = input.value;
+
 	std::string::size_type first = data.find_first_of("\"&<>", 0);
 	if (first == std::string::npos)
-		return data;
+		return output << data;
 
-	static std::string buffer;
-	buffer.reserve((size_t)(data.size() * 1.1f));
-	buffer.clear();
-
-	for (size_t pos = 0; pos != data.size(); ++pos)
+	output << StringRef(data.data(), first);
+	for (size_t pos = first; pos != data.size(); ++pos)
 	{
 		switch (data[pos])
 		{
-		case '&':  buffer.append("&amp;");       break;
-		case '\"': buffer.append("&quot;");      break;
-		case '\'': buffer.append("&apos;");      break;
-		case '<':  buffer.append("&lt;");        break;
-		case '>':  buffer.append("&gt;");        break;
-		default:   buffer.append(&data[pos], 1); break;
+		case '&':  output << "&amp;";         break;
+		case '\"': output << "&quot;";        break;
+		case '\'': output << "&apos;";        break;
+		case '<':  output << "&lt;";          break;
+		case '>':  output << "&gt;";          break;
+		default:   output << data[pos];       break;
 		}
 	}
 
-	return buffer;
+	return output;
 }
 
 inline bool isInt64(const UserTypeInfo& typeInfo)
@@ -857,6 +1074,11 @@ inline bool isSmallVector(int flags)
 	return (flags & (int)TypeFlags::SmallVector) != 0;
 }
 
+inline bool isSpan(int flags)
+{
+	return (flags & (int)TypeFlags::Span) != 0;
+}
+
 inline bool isArrayOrVector(int flags)
 {
 	return (flags & ((int)TypeFlags::Vector | (int)TypeFlags::Array | (int)TypeFlags::SmallVector)) != 0;
@@ -1018,6 +1240,32 @@ inline bool isCSOnly(int flags)
 	return (flags & (int)MethodFlags::CSOnly) != 0;
 }
 
+inline bool fillsBuffer(int flags)
+{
+	return (flags & (int)MethodFlags::FillsBuffer) != 0;
+}
+
+inline bool isBatchCall(int flags)
+{
+	return (flags & (int)MethodFlags::BatchCall) != 0;
+}
+
+inline bool isDeferred(int flags)
+{
+	return (flags & (int)MethodFlags::Deferred) != 0;
+}
+
+inline bool isCoalesced(int flags)
+{
+	return (flags & (int)MethodFlags::Coalesced) != 0;
+}
+
+/** Checks is the method a variant generated from another method, with no direct native counterpart. */
+inline bool isGeneratedVariant(int flags)
+{
+	return (flags & ((int)MethodFlags::FillsBuffer | (int)MethodFlags::BatchCall)) != 0;
+}
+
 inline bool canBeReturned(ParsedType type, int flags)
 {
 	if (isOutput(flags))
@@ -1127,20 +1375,14 @@ inline std::string getRelativeTo(const StringRef& path, const StringRef& relativ
 	return std::string(output.data(), output.size());
 }
 
-inline void getDerivedClasses(const std::string& typeName, std::vector<std::string>& output, bool onlyDirect = false)
+inline ArrayRef<std::string> getDerivedClasses(const std::string& typeName)
 {
-	auto iterFind = baseClassLookup.find(typeName);
-	if(iterFind == baseClassLookup.end())
-		return;
-
-	for(auto& entry : iterFind->second.childClasses)
-	{
-		output.push_back(entry);
-
-		if(!onlyDirect)
-			getDerivedClasses(entry, output);
-	}
+	return classHierarchy.getDerivedClasses(typeName);
 }
 
-void generateAll(StringRef cppEngineOutputFolder, StringRef cppEditorOutputFolder, StringRef csEngineOutputFolder, 
-	StringRef csEditorOutputFolder, bool genEditor);
\ No newline at end of file
+/** 
+ * Post-processes the parsed information and generates all the output files. Returns false if generation succeeded, but
+ * one of the requested checks failed.
+ */
+bool generateAll(StringRef cppEngineOutputFolder, StringRef cppEditorOutputFolder, StringRef csEngineOutputFolder, 
+	StringRef csEditorOutputFolder, bool genEditor, bool checkDeterminism);
\ No newline at end of file
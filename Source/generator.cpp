@@ -1,5 +1,7 @@
 #include "common.h"
+#include <atomic>
 #include <chrono>
+#include <thread>
 
 std::string getInteropCppVarType(const std::string& typeName, ParsedType type, int flags, bool forStruct = false)
 {
@@ -95,7 +97,7 @@ std::string getCppVarType(const std::string& typeName, ParsedType type, int flag
 std::string getCSVarType(const std::string& typeName, ParsedType type, int flags, bool paramPrefixes,
 	bool arraySuffixes, bool forceStructAsRef, bool forSignature = false)
 {
-	std::stringstream output;
+	CodeWriter output(256);
 
 	if (!forSignature)
 	{
@@ -126,7 +128,7 @@ std::string generateGetInternalLine(const std::string& sourceClassName, const st
 	bool isRRef = getPassAsResourceRef(flags);
 	bool isBase = isBaseParam(flags);
 
-	std::stringstream output;
+	CodeWriter output(256);
 	if (isClassType(classType))
 		output << obj << "->getInternal()";
 	else if(classType == ParsedType::GUIElement)
@@ -165,11 +167,11 @@ std::string generateManagedToScriptObjectLine(const std::string& indent, const s
 	bool isRRef = getPassAsResourceRef(flags);
 	bool isBase = isBaseParam(flags);
 
-	std::stringstream output;
+	CodeWriter output(256);
 	if (!isBase || isRRef)
 	{
-		output << indent << scriptType << "* " << scriptName << ";" << std::endl;
-		output << indent << scriptName << " = " << scriptType << "::toNative(" << name << ");" << std::endl;
+		output << indent << scriptType << "* " << scriptName << ";\n";
+		output << indent << scriptName << " = " << scriptType << "::toNative(" << name << ");\n";
 	}
 	else
 	{
@@ -179,8 +181,8 @@ std::string generateManagedToScriptObjectLine(const std::string& indent, const s
 		else
 			scriptBaseType = scriptType + "Base";
 
-		output << indent << scriptBaseType << "* " << scriptName << ";" << std::endl;
-		output << indent << scriptName << " = (" << scriptBaseType << "*)" << scriptType << "::toNative(" << name << ");" << std::endl;
+		output << indent << scriptBaseType << "* " << scriptName << ";\n";
+		output << indent << scriptName << " = (" << scriptBaseType << "*)" << scriptType << "::toNative(" << name << ");\n";
 	}
 
 	return output.str();
@@ -373,6 +375,24 @@ std::string getAsCppToInteropArgument(const std::string& name, ParsedType type,
 	}
 }
 
+/**
+ * Checks should the interop wrappers for the provided type be allocated from a per-type pool. Only plain class wrappers
+ * qualify, as other wrapper types are destroyed by their framework base classes.
+ */
+bool usesPooledWrapperAllocation(ParsedType type, bool isModule)
+{
+	return sPoolWrapperAllocations && type == ParsedType::Class && !isModule;
+}
+
+/** Generates an expression that allocates and constructs a new interop wrapper object, using the provided arguments. */
+std::string generateWrapperAllocation(const std::string& interopClassName, ParsedType type, const std::string& args)
+{
+	if (usesPooledWrapperAllocation(type, false))
+		return "bs_pool_new<" + interopClassName + ">(" + args + ")";
+
+	return "new (bs_alloc<" + interopClassName + ">()) " + interopClassName + "(" + args + ")";
+}
+
 std::string getScriptInteropType(const std::string& name, bool resourceRef = false)
 {
 	auto iterFind = cppToCsTypeMap.find(name);
@@ -533,6 +553,10 @@ void gatherIncludes(const std::string& typeName, int flags, bool isEditor, Inclu
 			if (isClassType(typeInfo.type) && !isSrcSPtr(flags))
 				sourceIncludeType = IT_HEADER;
 
+			// Complex structs are converted from their interop type in the source file, which requires the declaration
+			if (typeInfo.type == ParsedType::Struct && isComplexStruct(flags) && sourceIncludeType == 0)
+				sourceIncludeType = IT_IMPL;
+
 			output.includes[typeName] = IncludeInfo(typeName, typeInfo, sourceIncludeType, interopIncludeType, isStruct, isEditor);
 		}
 
@@ -541,8 +565,7 @@ void gatherIncludes(const std::string& typeName, int flags, bool isEditor, Inclu
 			bool isBase = isBaseParam(flags);
 			if (isBase)
 			{
-				std::vector<std::string> derivedClasses;
-				getDerivedClasses(typeName, derivedClasses);
+				ArrayRef<std::string> derivedClasses = getDerivedClasses(typeName);
 
 				for (auto& entry : derivedClasses)
 					output.includes[entry] = IncludeInfo(entry, getTypeInfo(entry, 0), IT_IMPL, IT_IMPL, false, isEditor);
@@ -632,8 +655,7 @@ void gatherIncludes(const FieldInfo& fieldInfo, bool isEditor, IncludesInfo& out
 			bool isBase = isBaseParam(fieldInfo.flags);
 			if (isBase)
 			{
-				std::vector<std::string> derivedClasses;
-				getDerivedClasses(fieldInfo.typeName, derivedClasses);
+				ArrayRef<std::string> derivedClasses = getDerivedClasses(fieldInfo.typeName);
 
 				for(auto& entry : derivedClasses)
 					output.includes[entry] = IncludeInfo(entry, getTypeInfo(entry, 0), IT_IMPL, IT_IMPL, false, isEditor);
@@ -672,7 +694,12 @@ void gatherIncludes(const StructInfo& structInfo, IncludesInfo& output)
 	}
 }
 
-bool parseCopydocString(const std::string& str, const std::string& parentType, const SmallVector<std::string, 4>& curNS, CommentEntry& outputComment)
+/** 
+ * Finds the comment referenced by a @copydoc command, or null if it cannot be found. The found comment can itself contain
+ * a @copydoc command. Diagnostics are written to @p log.
+ */
+const CommentEntry* findCopydocTarget(const std::string& str, const std::string& parentType, ArrayRef<std::string> curNS, 
+	raw_ostream& log)
 {
 	StringRef inputStr(str.data(), str.length());
 	inputStr = inputStr.trim();
@@ -720,8 +747,8 @@ bool parseCopydocString(const std::string& str, const std::string& parentType, c
 
 		if (iterFind == commentSimpleLookup.end())
 		{
-			outs() << "Warning: Cannot find identifier referenced by the @copydoc command: \"" << str << "\".\n";
-			return false;
+			log << "Warning: Cannot find identifier referenced by the @copydoc command: \"" << str << "\".\n";
+			return nullptr;
 		}
 		else
 			lookup = iterFind->second;
@@ -740,8 +767,8 @@ bool parseCopydocString(const std::string& str, const std::string& parentType, c
 			iterFind = commentSimpleLookup.find(simpleTypeName);
 			if (iterFind == commentSimpleLookup.end())
 			{
-				outs() << "Warning: Cannot find identifier referenced by the @copydoc command: \"" << str << "\".\n";
-				return false;
+				log << "Warning: Cannot find identifier referenced by the @copydoc command: \"" << str << "\".\n";
+				return nullptr;
 			}
 			else
 				lookup = iterFind->second;
@@ -818,8 +845,8 @@ bool parseCopydocString(const std::string& str, const std::string& parentType, c
 
 	if (entryMatch == -1)
 	{
-		outs() << "Warning: Cannot find identifier referenced by the @copydoc command: \"" << str << "\".\n";
-		return false;
+		log << "Warning: Cannot find identifier referenced by the @copydoc command: \"" << str << "\".\n";
+		return nullptr;
 	}
 
 	CommentInfo& finalCommentInfo = commentInfos[lookup[entryMatch]];
@@ -827,8 +854,8 @@ bool parseCopydocString(const std::string& str, const std::string& parentType, c
 	{
 		if (!finalCommentInfo.isFunction)
 		{
-			outs() << "Warning: Cannot find identifier referenced by the @copydoc command: \"" << str << "\".\n";
-			return false;
+			log << "Warning: Cannot find identifier referenced by the @copydoc command: \"" << str << "\".\n";
+			return nullptr;
 		}
 
 		SmallVector<StringRef, 8> paramSplits;
@@ -867,56 +894,271 @@ bool parseCopydocString(const std::string& str, const std::string& parentType, c
 				overloadMatch = 0;
 			else
 			{
-				outs() << "Warning: Cannot find identifier referenced by the @copydoc command: \"" << str << "\".\n";
-				return false;
+				log << "Warning: Cannot find identifier referenced by the @copydoc command: \"" << str << "\".\n";
+				return nullptr;
 			}
 		}
 
-		outputComment = finalCommentInfo.overloads[overloadMatch].comment;
-		return true;
+		return &finalCommentInfo.overloads[overloadMatch].comment;
 	}
 
 	if (finalCommentInfo.isFunction)
-		outputComment = finalCommentInfo.overloads[0].comment;
-	else
-		outputComment = finalCommentInfo.comment;
+		return &finalCommentInfo.overloads[0].comment;
 
-	return true;
+	return &finalCommentInfo.comment;
 }
 
-void resolveCopydocComment(CommentEntry& comment, const std::string& parentType, const SmallVector<std::string, 4>& curNS)
+/** Returns the argument of the @copydoc command in the provided comment, or an empty string if there is no such command. */
+StringRef getCopydocArgument(const CommentEntry& comment)
 {
-	StringRef copydocArg;
 	for(auto& entry : comment.brief)
 	{
 		StringRef commentRef(entry.text.data(), entry.text.length());
 
 		if (commentRef.startswith("@copydoc"))
+			return commentRef.split(' ').second;
+	}
+
+	return StringRef();
+}
+
+/**
+ * Resolves @copydoc references between parsed comments. Every comment is resolved at most once and the result is shared
+ * between all comments referencing it.
+ */
+class CopydocResolver
+{
+public:
+	CopydocResolver()
+	{
+		for (auto& commentInfo : commentInfos)
 		{
-			copydocArg = commentRef.split(' ').second;
-			break;
+			if (commentInfo.isFunction)
+			{
+				for (auto& overload : commentInfo.overloads)
+					ownerLookup[&overload.comment] = &commentInfo;
+			}
+			else
+				ownerLookup[&commentInfo.comment] = &commentInfo;
 		}
 	}
 
-	if (copydocArg.empty())
-		return;
+	/**
+	 * Follows the chain of @copydoc commands starting at the provided comment and returns the first comment that
+	 * contains actual documentation. Returns null if the chain cannot be resolved or if it is cyclic.
+	 */
+	const CommentEntry* resolve(const CommentEntry* comment)
+	{
+		SmallVector<const CommentEntry*, 8> path;
+
+		const CommentEntry* output = nullptr;
+		const CommentEntry* current = comment;
+		while (current != nullptr)
+		{
+			auto iterFind = resolvedLookup.find(current);
+			if (iterFind != resolvedLookup.end())
+			{
+				output = iterFind->second;
+				break;
+			}
+
+			StringRef copydocArg = getCopydocArgument(*current);
+			if (copydocArg.empty())
+			{
+				output = current;
+				break;
+			}
+
+			auto iterFindPath = std::find(path.begin(), path.end(), current);
+			if (iterFindPath != path.end())
+			{
+				outs() << "Warning: Found a cyclic @copydoc reference: ";
+				for (auto I = iterFindPath; I != path.end(); ++I)
+					outs() << "\"" << getOwnerName(*I) << "\" -> ";
+
+				outs() << "\"" << getOwnerName(current) << "\". Ignoring the comments.\n";
+				break;
+			}
+
+			path.push_back(current);
+
+			const CommentInfo* owner = ownerLookup[current];
+			current = findCopydocTarget(copydocArg, getParentType(*owner), owner->namespaces, outs());
+		}
+
+		for (auto& entry : path)
+			resolvedLookup[entry] = output;
+
+		return output;
+	}
+
+private:
+	/** Returns the name of the type containing the commented entry, used for resolving relative references. */
+	static std::string getParentType(const CommentInfo& commentInfo)
+	{
+		StringRef name(commentInfo.name.data(), commentInfo.name.length());
+
+		size_t separatorIdx = name.rfind("::");
+		if (separatorIdx == StringRef::npos)
+			return commentInfo.name;
+
+		return name.substr(0, separatorIdx).str();
+	}
+
+	std::string getOwnerName(const CommentEntry* comment)
+	{
+		return ownerLookup[comment]->fullName;
+	}
+
+	std::unordered_map<const CommentEntry*, const CommentInfo*> ownerLookup;
+	std::unordered_map<const CommentEntry*, const CommentEntry*> resolvedLookup;
+};
+
+/** Comment with a @copydoc command, along with the comment it references. */
+struct CopydocReference
+{
+	CommentEntry* comment;
+	const CommentEntry* target;
+};
+
+/** Finds all comments with @copydoc commands in the provided file, and the comments they directly reference. */
+void findCopydocReferences(FileInfo& fileInfo, SmallVectorImpl<CopydocReference>& output, raw_ostream& log)
+{
+	auto addReference = [&output, &log](CommentEntry& comment, const std::string& parentType, ArrayRef<std::string> curNS)
+	{
+		StringRef copydocArg = getCopydocArgument(comment);
+		if (copydocArg.empty())
+			return;
+
+		output.push_back({ &comment, findCopydocTarget(copydocArg, parentType, curNS, log) });
+	};
+
+	for (auto& classInfo : fileInfo.classInfos)
+	{
+		addReference(classInfo.documentation, classInfo.name, classInfo.ns);
+
+		for (auto& methodInfo : classInfo.methodInfos)
+			addReference(methodInfo.documentation, classInfo.name, classInfo.ns);
+
+		for (auto& ctorInfo : classInfo.ctorInfos)
+			addReference(ctorInfo.documentation, classInfo.name, classInfo.ns);
+
+		for (auto& eventInfo : classInfo.eventInfos)
+			addReference(eventInfo.documentation, classInfo.name, classInfo.ns);
+	}
+
+	for (auto& structInfo : fileInfo.structInfos)
+		addReference(structInfo.documentation, structInfo.name, structInfo.ns);
+
+	for(auto& enumInfo : fileInfo.enumInfos)
+	{
+		addReference(enumInfo.documentation, enumInfo.name, enumInfo.ns);
+
+		for (auto& enumEntryInfo : enumInfo.entries)
+			addReference(enumEntryInfo.second.documentation, enumInfo.name, enumInfo.ns);
+	}
+}
 
-	CommentEntry outComment;
-	if (!parseCopydocString(copydocArg, parentType, curNS, outComment))
+/** Executes the provided function for every index in range [0, count), distributing the work over all hardware threads. */
+template<class T>
+void parallelFor(int count, const T& func)
+{
+	int numThreads = std::min((int)std::thread::hardware_concurrency(), count);
+	if (numThreads <= 1)
 	{
-		comment = CommentEntry();
+		for (int i = 0; i < count; i++)
+			func(i);
+
 		return;
 	}
-	else
-		comment = outComment;
 
-	resolveCopydocComment(comment, parentType, curNS);
+	std::atomic<int> nextIdx(0);
+	auto worker = [&nextIdx, count, &func]()
+	{
+		while (true)
+		{
+			int idx = nextIdx++;
+			if (idx >= count)
+				break;
+
+			func(idx);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < numThreads; i++)
+		threads.push_back(std::thread(worker));
+
+	for (auto& thread : threads)
+		thread.join();
 }
 
-std::string generateXMLCommentText(const CommentText& commentTextEntry)
+typedef std::pair<const std::string, FileInfo> OutputFileEntry;
+
+/**
+ * Executes the provided function for every output file, distributing the files over all hardware threads. Diagnostics
+ * written to the log provided to the function, or by the type mapping helpers, are output in file order, once all the 
+ * files have been processed.
+ */
+template<class T>
+void forEachFileParallel(const std::vector<OutputFileEntry*>& files, const T& func)
+{
+	int numFiles = (int)files.size();
+	std::vector<std::string> logs(numFiles);
+
+	parallelFor(numFiles, [&files, &logs, &func](int idx)
+	{
+		raw_string_ostream log(logs[idx]);
+
+		sTypeMappingLog = &log;
+		func(idx, *files[idx], log);
+		sTypeMappingLog = nullptr;
+
+		log.flush();
+	});
+
+	for (auto& entry : logs)
+		outs() << entry;
+}
+
+/**
+ * Replaces all comments containing @copydoc commands with the comments they reference. Comments that cannot be resolved
+ * are cleared.
+ */
+void resolveCopydocComments(const std::vector<OutputFileEntry*>& files)
+{
+	std::vector<SmallVector<CopydocReference, 4>> references(files.size());
+
+	// Find directly referenced comments
+	forEachFileParallel(files, [&references](int idx, OutputFileEntry& file, raw_ostream& log)
+	{
+		findCopydocReferences(file.second, references[idx], log);
+	});
+
+	// Follow the reference chains. Each referenced comment is resolved only once.
+	CopydocResolver resolver;
+	for (auto& fileReferences : references)
+	{
+		for (auto& entry : fileReferences)
+			entry.target = resolver.resolve(entry.target);
+	}
+
+	// Assign the resolved comments
+	forEachFileParallel(files, [&references](int idx, OutputFileEntry& file, raw_ostream& log)
+	{
+		for (auto& entry : references[idx])
+		{
+			if (entry.target != nullptr)
+				*entry.comment = *entry.target;
+			else
+				*entry.comment = CommentEntry();
+		}
+	});
+}
+
+void generateXMLCommentText(const CommentText& commentTextEntry, CodeWriter& output)
 {
 	uint32_t idx = 0;
-	std::stringstream output;
 
 	for(auto& entry : commentTextEntry.text)
 	{
@@ -950,38 +1192,41 @@ std::string generateXMLCommentText(const CommentText& commentTextEntry)
 
 		idx++;
 	}
+}
+
+std::string generateXMLCommentText(const CommentText& commentTextEntry)
+{
+	CodeWriter output(commentTextEntry.text.size() + 64);
+	generateXMLCommentText(commentTextEntry, output);
 
 	return output.str();
 }
- std::string generateXMLCommentText(const SmallVector<CommentText, 2>& input)
- {
-	 std::stringstream output;
-	 for (auto I = input.begin(); I != input.end(); ++I)
-	 {
-		 if (I != input.begin())
-			 output << "\n";
 
-		 std::string text = generateXMLCommentText(*I);
-		 output << text;
-	 }
+void generateXMLCommentText(const SmallVector<CommentText, 2>& input, CodeWriter& output)
+{
+	for (auto I = input.begin(); I != input.end(); ++I)
+	{
+		if (I != input.begin())
+			output << "\n";
 
-	return output.str();
- }
+		generateXMLCommentText(*I, output);
+	}
+}
 
-std::string generateXMLComments(const CommentEntry& commentEntry, const std::string& indent)
+void generateXMLComments(const CommentEntry& commentEntry, const std::string& indent, CodeWriter& output)
 {
-	std::stringstream output;
-	
-	auto wordWrap = [](const std::string& input, const std::string& linePrefix, int columnLength = 124)
+	auto wordWrap = [&output](const std::string& input, const std::string& linePrefix, int columnLength = 124)
 	{
 		int prefixLength = (int)linePrefix.length();
 		int inputLength = (int)input.length();
 
 		if ((inputLength + prefixLength) <= columnLength)
-			return linePrefix + input + "\n";
+		{
+			output << linePrefix << input << "\n";
+			return;
+		}
 
 		StringRef inputRef(input.data(), input.length());
-		std::stringstream wordWrapped;
 
 		int lineLength = columnLength - prefixLength;
 		int curIdx = 0;
@@ -991,7 +1236,7 @@ std::string generateXMLComments(const CommentEntry& commentEntry, const std::str
 			if(remainingLength <= lineLength)
 			{
 				StringRef lineRef = inputRef.substr(curIdx, remainingLength);
-				wordWrapped << linePrefix << lineRef.str() << std::endl;
+				output << linePrefix << lineRef << "\n";
 				break;
 			}
 			else
@@ -1001,7 +1246,7 @@ std::string generateXMLComments(const CommentEntry& commentEntry, const std::str
 				{
 					StringRef lineRef = inputRef.substr(curIdx, lineLength);
 
-					wordWrapped << linePrefix << lineRef.str() << std::endl;
+					output << linePrefix << lineRef << "\n";
 					curIdx += lineLength;
 				}
 				else
@@ -1009,13 +1254,11 @@ std::string generateXMLComments(const CommentEntry& commentEntry, const std::str
 					int length = lastSpace - curIdx + 1;
 					StringRef lineRef = inputRef.substr(curIdx, length);
 
-					wordWrapped << linePrefix << lineRef.str() << std::endl;
+					output << linePrefix << lineRef << "\n";
 					curIdx += length;
 				}
 			}
 		}
-		
-		return wordWrapped.str();
 	};
 
 	auto printParagraphs = [&output, &indent, &wordWrap](const std::string& head, const std::string& tail, const SmallVector<CommentText, 2>& input)
@@ -1046,7 +1289,7 @@ std::string generateXMLComments(const CommentEntry& commentEntry, const std::str
 					output << indent << "///\n";
 
 				std::string text = generateXMLCommentText(*I);
-				output << wordWrap(text, indent + "/// ");
+				wordWrap(text, indent + "/// ");
 			}
 			output << indent << "/// " << tail << "\n";
 		}
@@ -1062,7 +1305,7 @@ std::string generateXMLComments(const CommentEntry& commentEntry, const std::str
 	else
 	{
 		if(!commentEntry.params.empty() || !commentEntry.returns.empty())
-			output << indent << "/// <summary></summary>" << std::endl;
+			output << indent << "/// <summary></summary>\n";
 	}
 
 	for(auto& entry : commentEntry.params)
@@ -1075,8 +1318,6 @@ std::string generateXMLComments(const CommentEntry& commentEntry, const std::str
 
 	if(!commentEntry.returns.empty())
 		printParagraphs("<returns>", "</returns>", commentEntry.returns);
-
-	return output.str();
 }
 
 void handleDefaultParams(MethodInfo& methodInfo, std::vector<MethodInfo>& newMethodInfos)
@@ -1171,240 +1412,416 @@ StructInfo* findStructInfo(const std::string& name)
 	return nullptr;
 };
 
-void postProcessFileInfos()
+/** Lookup of class, struct and enum infos from all output files, by name. */
+struct OutputInfoLookup
 {
-	// Inject external methods into their appropriate class infos
-	auto findClassInfo = [](const std::string& name, bool isEditor) -> ClassInfo*
+	OutputInfoLookup()
 	{
 		for (auto& fileInfo : outputFileInfos)
 		{
 			for (auto& classInfo : fileInfo.second.classInfos)
-			{
-				if (classInfo.name != name)
-					continue;
+				classInfos[classInfo.name].push_back(&classInfo);
 
-				// Two versions of editor and BSF class migth exist, make sure to pick the right one
-				if((isEditor && classInfo.api == ApiFlags::BSF) || (!isEditor &&  hasAPIBED(classInfo.api)))
-					continue;
+			for (auto& structInfo : fileInfo.second.structInfos)
+				structInfos.insert(std::make_pair(structInfo.name, &structInfo));
 
-				return &classInfo;
-			}
+			for (auto& enumInfo : fileInfo.second.enumInfos)
+				enumInfos.insert(std::make_pair(enumInfo.name, &enumInfo));
 		}
+	}
 
-		return nullptr;
-	};
-
-	auto findEnumInfo = [](const std::string& name) -> EnumInfo*
+	ClassInfo* findClassInfo(const std::string& name, bool isEditor) const
 	{
-		for (auto& fileInfo : outputFileInfos)
+		auto iterFind = classInfos.find(name);
+		if (iterFind == classInfos.end())
+			return nullptr;
+
+		for (auto& classInfo : iterFind->second)
 		{
-			for (auto& enumInfo : fileInfo.second.enumInfos)
-			{
-				if (enumInfo.name == name)
-					return &enumInfo;
-			}
+			// Two versions of editor and BSF class migth exist, make sure to pick the right one
+			if((isEditor && classInfo->api == ApiFlags::BSF) || (!isEditor &&  hasAPIBED(classInfo->api)))
+				continue;
+
+			return classInfo;
 		}
 
 		return nullptr;
-	};
+	}
+
+	StructInfo* findStructInfo(const std::string& name) const
+	{
+		auto iterFind = structInfos.find(name);
+		if (iterFind == structInfos.end())
+			return nullptr;
+
+		return iterFind->second;
+	}
+
+	EnumInfo* findEnumInfo(const std::string& name) const
+	{
+		auto iterFind = enumInfos.find(name);
+		if (iterFind == enumInfos.end())
+			return nullptr;
+
+		return iterFind->second;
+	}
+
+	std::unordered_map<std::string, SmallVector<ClassInfo*, 2>> classInfos;
+	std::unordered_map<std::string, StructInfo*> structInfos;
+	std::unordered_map<std::string, EnumInfo*> enumInfos;
+};
 
+/** 
+ * Injects external methods into their appropriate class infos. External methods are moved out of the external class
+ * infos.
+ * 
+ * Reads: external class infos. Writes: methods of classes in any file.
+ */
+void injectExternalMethods(const OutputInfoLookup& lookup)
+{
 	for (auto& entry : externalClassInfos)
 	{
-		for (auto& fileInfo : outputFileInfos)
+		auto iterFindClass = lookup.classInfos.find(entry.first);
+		if (iterFindClass == lookup.classInfos.end())
+			continue;
+
+		// Both the editor and the BSF version of the class can exist
+		const SmallVector<ClassInfo*, 2>& classInfos = iterFindClass->second;
+		for (auto& method : entry.second.methods)
 		{
-			for (auto& classInfo : fileInfo.second.classInfos)
+			if (((int)method.flags & (int)MethodFlags::Constructor) != 0)
 			{
-				if (classInfo.name != entry.first)
+				if (method.returnInfo.typeName.size() == 0)
+				{
+					outs() << "Error: Found an external constructor \"" << method.sourceName << "\" with no return value, skipping.\n";
 					continue;
+				}
 
-				for (auto& method : entry.second.methods)
+				if (method.returnInfo.typeName != entry.first)
 				{
-					if (((int)method.flags & (int)MethodFlags::Constructor) != 0)
-					{
-						if (method.returnInfo.typeName.size() == 0)
-						{
-							outs() << "Error: Found an external constructor \"" << method.sourceName << "\" with no return value, skipping.\n";
-							continue;
-						}
+					outs() << "Error: Found an external constructor \"" << method.sourceName << "\" whose return value doesn't match the external class, skipping.\n";
+					continue;
+				}
+			}
+			else
+			{
+				if (method.paramInfos.size() == 0)
+				{
+					outs() << "Error: Found an external method \"" << method.sourceName << "\" with no parameters. This isn't supported, skipping.\n";
+					continue;
+				}
 
-						if (method.returnInfo.typeName != entry.first)
-						{
-							outs() << "Error: Found an external constructor \"" << method.sourceName << "\" whose return value doesn't match the external class, skipping.\n";
-							continue;
-						}
-					}
-					else
-					{
-						if (method.paramInfos.size() == 0)
-						{
-							outs() << "Error: Found an external method \"" << method.sourceName << "\" with no parameters. This isn't supported, skipping.\n";
-							continue;
-						}
+				if (method.paramInfos[0].typeName != entry.first)
+				{
+					outs() << "Error: Found an external method \"" << method.sourceName << "\" whose first parameter doesn't "
+						" accept the class its operating on. This is not supported, skipping. \n";
+					continue;
+				}
 
-						if (method.paramInfos[0].typeName != entry.first)
-						{
-							outs() << "Error: Found an external method \"" << method.sourceName << "\" whose first parameter doesn't "
-								" accept the class its operating on. This is not supported, skipping. \n";
-							continue;
-						}
+				// Note: Only done once per method, regardless of the number of classes it gets injected in
+				method.paramInfos.erase(method.paramInfos.begin());
+			}
 
-						method.paramInfos.erase(method.paramInfos.begin());
-					}
+			for (int i = 0; i < (int)classInfos.size() - 1; i++)
+				classInfos[i]->methodInfos.push_back(method);
 
-					classInfo.methodInfos.push_back(method);
-				}
-			}
+			classInfos.back()->methodInfos.push_back(std::move(method));
 		}
+
+		entry.second.methods.clear();
 	}
+}
 
-	// Resolve copydoc comment commands
-	for (auto& fileInfo : outputFileInfos)
+/** Returns a name based on @p baseName, that isn't used by any of the parameters of the provided method. */
+std::string getUniqueParamName(const MethodInfo& methodInfo, const std::string& baseName)
+{
+	std::string name = baseName;
+	for (int i = 0; ; i++)
 	{
-		for (auto& classInfo : fileInfo.second.classInfos)
-		{
-			resolveCopydocComment(classInfo.documentation, classInfo.name, classInfo.ns);
+		auto iterFind = std::find_if(methodInfo.paramInfos.begin(), methodInfo.paramInfos.end(), 
+			[&name](const VarInfo& paramInfo) { return paramInfo.name == name; });
 
-			for (auto& methodInfo : classInfo.methodInfos)
-				resolveCopydocComment(methodInfo.documentation, classInfo.name, classInfo.ns);
+		if (iterFind == methodInfo.paramInfos.end())
+			return name;
 
-			for (auto& ctorInfo : classInfo.ctorInfos)
-				resolveCopydocComment(ctorInfo.documentation, classInfo.name, classInfo.ns);
+		name = baseName + std::to_string(i);
+	}
+}
 
-			for (auto& eventInfo : classInfo.eventInfos)
-				resolveCopydocComment(eventInfo.documentation, classInfo.name, classInfo.ns);
-		}
+/** 
+ * Generates an additional version of every method returning a vector, that writes its results into a caller provided
+ * managed array instead of allocating a new one on every call. The array is only reallocated if it is too small.
+ *
+ * Reads and writes: the provided class.
+ */
+void generateBufferOverloads(ClassInfo& classInfo)
+{
+	const int excludedFlags = (int)MethodFlags::CSOnly | (int)MethodFlags::InteropOnly | (int)MethodFlags::FieldWrapper |
+		(int)MethodFlags::PropertyGetter | (int)MethodFlags::PropertySetter;
 
-		for (auto& structInfo : fileInfo.second.structInfos)
-			resolveCopydocComment(structInfo.documentation, structInfo.name, structInfo.ns);
+	std::vector<MethodInfo> newMethodInfos;
+	for (auto& methodInfo : classInfo.methodInfos)
+	{
+		if ((methodInfo.flags & excludedFlags) != 0)
+			continue;
 
-		for(auto& enumInfo : fileInfo.second.enumInfos)
-		{
-			resolveCopydocComment(enumInfo.documentation, enumInfo.name, enumInfo.ns);
+		const ReturnInfo& returnInfo = methodInfo.returnInfo;
+		if (returnInfo.typeName.empty() || getIsAsyncOp(returnInfo.flags))
+			continue;
 
-			for (auto& enumEntryInfo : enumInfo.entries)
-				resolveCopydocComment(enumEntryInfo.second.documentation, enumInfo.name, enumInfo.ns);
-		}
-	}
+		if (!isVector(returnInfo.flags) && !isSmallVector(returnInfo.flags))
+			continue;
 
-	// Generate unique interop method names
-	std::unordered_set<std::string> usedNames;
-	for (auto& fileInfo : outputFileInfos)
-	{
-		for (auto& classInfo : fileInfo.second.classInfos)
-		{
-			usedNames.clear();
+		UserTypeInfo returnTypeInfo = getTypeInfo(returnInfo.typeName, returnInfo.flags);
+		if (returnTypeInfo.type == ParsedType::GUIElement)
+			continue;
 
-			auto generateInteropName = [&usedNames](MethodInfo& methodInfo)
-			{
-				std::string interopName = methodInfo.sourceName;
-				int counter = 0;
-				while (true)
-				{
-					auto iterFind = usedNames.find(interopName);
-					if (iterFind == usedNames.end())
-						break;
+		MethodInfo bufferMethodInfo = methodInfo;
+		bufferMethodInfo.flags |= (int)MethodFlags::FillsBuffer;
 
-					interopName = methodInfo.sourceName + std::to_string(counter);
-					counter++;
-				}
+		// The buffer is appended as the last parameter, so no parameter before it can have a default value
+		for (auto& paramInfo : bufferMethodInfo.paramInfos)
+		{
+			paramInfo.defaultValue.clear();
+			paramInfo.defaultValueType.clear();
+			paramInfo.flags &= ~(int)TypeFlags::VarParams;
+		}
 
-				usedNames.insert(interopName);
-				methodInfo.interopName = interopName;
-			};
+		CommentText returnsDoc;
+		returnsDoc.text = "Number of elements written to the buffer.";
 
-			for (auto& methodInfo : classInfo.methodInfos)
-				generateInteropName(methodInfo);
+		CommentParamEntry bufferDoc;
+		bufferDoc.name = getUniqueParamName(methodInfo, "buffer");
+		bufferDoc.comments.push_back(CommentText());
+		bufferDoc.comments.back().text = "Array to write the results to. A new array is only allocated if it is null or too "
+			"small to hold all the results.";
 
-			for (auto& methodInfo : classInfo.ctorInfos)
-				generateInteropName(methodInfo);
+		bufferMethodInfo.documentation.returns.clear();
+		bufferMethodInfo.documentation.returns.push_back(returnsDoc);
+		bufferMethodInfo.documentation.params.push_back(bufferDoc);
 
-			for (auto& eventInfo : classInfo.eventInfos)
-				generateInteropName(eventInfo);
-		}
+		newMethodInfos.push_back(bufferMethodInfo);
 	}
 
-	// Generate property infos
-	for (auto& fileInfo : outputFileInfos)
-	{
-		for (auto& classInfo : fileInfo.second.classInfos)
-		{
-			for (auto& methodInfo : classInfo.methodInfos)
-			{
-				bool isGetter = (methodInfo.flags & (int)MethodFlags::PropertyGetter) != 0;
-				bool isSetter = (methodInfo.flags & (int)MethodFlags::PropertySetter) != 0;
-
-				if (!isGetter && !isSetter)
-					continue;
+	for (auto& methodInfo : newMethodInfos)
+		classInfo.methodInfos.push_back(methodInfo);
+}
 
-				PropertyInfo propertyInfo;
-				propertyInfo.name = methodInfo.scriptName;
-				propertyInfo.documentation = methodInfo.documentation;
-				propertyInfo.isStatic = (methodInfo.flags & (int)MethodFlags::Static);
-				propertyInfo.visibility = methodInfo.visibility;
-				propertyInfo.api = methodInfo.api;
-				propertyInfo.style = methodInfo.style;
+/** 
+ * Generates a static variant of every method marked with the "batch" export option, that calls the method on every 
+ * object in an array, with arguments provided in an array per parameter. This performs many calls in a single 
+ * transition between managed and native code.
+ *
+ * Reads and writes: the provided class.
+ */
+void generateBatchOverloads(ClassInfo& classInfo, raw_ostream& log)
+{
+	bool isModule = (classInfo.flags & (int)ClassFlags::IsModule) != 0;
 
-				if (isGetter)
-				{
-					propertyInfo.getter = methodInfo.interopName;
-					propertyInfo.type = methodInfo.returnInfo.typeName;
-					propertyInfo.typeFlags = methodInfo.returnInfo.flags;
-				}
-				else // Setter
-				{
-					propertyInfo.setter = methodInfo.interopName;
-					propertyInfo.type = methodInfo.paramInfos[0].typeName;
-					propertyInfo.typeFlags = methodInfo.paramInfos[0].flags;
-				}
+	std::vector<MethodInfo> newMethodInfos;
+	for (auto& methodInfo : classInfo.methodInfos)
+	{
+		if ((methodInfo.flags & (int)MethodFlags::Batched) == 0)
+			continue;
 
-				auto iterFind = std::find_if(classInfo.propertyInfos.begin(), classInfo.propertyInfos.end(),
-					[&propertyInfo](const PropertyInfo& info)
-				{
-					return propertyInfo.name == info.name;
-				});
+		bool isStatic = (methodInfo.flags & (int)MethodFlags::Static) != 0;
+		bool isCtor = (methodInfo.flags & (int)MethodFlags::Constructor) != 0;
+		bool isSetter = (methodInfo.flags & (int)MethodFlags::PropertySetter) != 0;
 
-				if (iterFind == classInfo.propertyInfos.end())
-					classInfo.propertyInfos.push_back(propertyInfo);
-				else
-				{
-					PropertyInfo& existingInfo = *iterFind;
-					if (existingInfo.type != propertyInfo.type || existingInfo.isStatic != propertyInfo.isStatic)
-					{
-						outs() << "Error: Getter and setter types for the property \"" << propertyInfo.name << "\" don't match. Skipping property.\n";
-						continue;
-					}
+		bool isValid = !isStatic && !isCtor && !isModule && !isCSOnly(methodInfo.flags) && 
+			methodInfo.returnInfo.typeName.empty();
 
-					if (!propertyInfo.getter.empty())
-					{
-						existingInfo.getter = propertyInfo.getter;
+		for (auto& paramInfo : methodInfo.paramInfos)
+		{
+			UserTypeInfo paramTypeInfo = getTypeInfo(paramInfo.typeName, paramInfo.flags);
+			if (isArrayOrVector(paramInfo.flags) || isOutput(paramInfo.flags) || isFlagsEnum(paramInfo.flags) || 
+				getIsAsyncOp(paramInfo.flags))
+				isValid = false;
+			else if (paramTypeInfo.type != ParsedType::Builtin && paramTypeInfo.type != ParsedType::Enum && 
+				paramTypeInfo.type != ParsedType::Struct)
+				isValid = false;
+		}
 
-						// Prefer documentation from setter, but use getter if no other available
-						if (existingInfo.documentation.brief.empty())
-							existingInfo.documentation = propertyInfo.documentation;
-					}
-					else
-					{
-						existingInfo.setter = propertyInfo.setter;
-						existingInfo.style = propertyInfo.style; // Always prefer style flags from the setter
+		if (!isValid)
+		{
+			log << "Warning: Cannot generate a batched version of \"" << classInfo.name << "::" << methodInfo.sourceName << 
+				"\". Only non-static methods with no return value and builtin, enum or struct parameters can be batched.\n";
+			continue;
+		}
 
-						if (!propertyInfo.documentation.brief.empty())
-							existingInfo.documentation = propertyInfo.documentation;
-					}
-				}
+		MethodInfo batchMethodInfo = methodInfo;
+		batchMethodInfo.flags &= ~((int)MethodFlags::Batched | (int)MethodFlags::PropertySetter);
+		batchMethodInfo.flags |= (int)MethodFlags::BatchCall | (int)MethodFlags::Static;
+		batchMethodInfo.scriptName = (isSetter ? "Set" : "") + methodInfo.scriptName + "Batched";
+
+		// Objects to call the method on, followed by an array of arguments for each of the original parameters
+		VarInfo objectsInfo;
+		objectsInfo.name = getUniqueParamName(methodInfo, "objects");
+		objectsInfo.typeName = classInfo.name;
+		objectsInfo.flags = (int)TypeFlags::Vector | (int)TypeFlags::SrcSPtr;
+		objectsInfo.arraySize = 0;
+
+		batchMethodInfo.paramInfos.clear();
+		batchMethodInfo.paramInfos.push_back(objectsInfo);
+
+		for (auto& paramInfo : methodInfo.paramInfos)
+		{
+			VarInfo batchParamInfo = paramInfo;
+			batchParamInfo.flags |= (int)TypeFlags::Vector;
+			batchParamInfo.defaultValue.clear();
+			batchParamInfo.defaultValueType.clear();
+
+			batchMethodInfo.paramInfos.push_back(batchParamInfo);
+		}
+
+		CommentText briefDoc;
+		briefDoc.text = "Calls " + methodInfo.scriptName + " on every object in the provided array, in a single call to native "
+			"code. Arguments for each object are read from the parameter arrays, at the same index as the object.";
+
+		CommentParamEntry objectsDoc;
+		objectsDoc.name = objectsInfo.name;
+		objectsDoc.comments.push_back(CommentText());
+		objectsDoc.comments.back().text = "Objects to call the method on. Null entries are skipped.";
+
+		batchMethodInfo.documentation.brief.clear();
+		batchMethodInfo.documentation.brief.push_back(briefDoc);
+		batchMethodInfo.documentation.params.insert(batchMethodInfo.documentation.params.begin(), objectsDoc);
+
+		newMethodInfos.push_back(batchMethodInfo);
+	}
+
+	for (auto& methodInfo : newMethodInfos)
+		classInfo.methodInfos.push_back(methodInfo);
+}
+
+/** 
+ * Generates unique interop names for all methods, constructors and events of the class. 
+ *
+ * Reads and writes: the provided class.
+ */
+void generateInteropNames(ClassInfo& classInfo)
+{
+	std::unordered_set<std::string> usedNames;
+	auto generateInteropName = [&usedNames](MethodInfo& methodInfo)
+	{
+		std::string interopName = methodInfo.sourceName;
+		int counter = 0;
+		while (true)
+		{
+			auto iterFind = usedNames.find(interopName);
+			if (iterFind == usedNames.end())
+				break;
+
+			interopName = methodInfo.sourceName + std::to_string(counter);
+			counter++;
+		}
+
+		usedNames.insert(interopName);
+		methodInfo.interopName = interopName;
+	};
+
+	for (auto& methodInfo : classInfo.methodInfos)
+		generateInteropName(methodInfo);
+
+	for (auto& methodInfo : classInfo.ctorInfos)
+		generateInteropName(methodInfo);
+
+	for (auto& eventInfo : classInfo.eventInfos)
+		generateInteropName(eventInfo);
+}
+
+/** 
+ * Generates property infos from property getter and setter methods of the class. Requires interop names to be generated.
+ * Documentation and style of the property methods is moved into the property infos.
+ *
+ * Reads and writes: the provided class.
+ */
+void generatePropertyInfos(ClassInfo& classInfo, raw_ostream& log)
+{
+	std::unordered_map<std::string, int> propertyLookup;
+	for (auto& methodInfo : classInfo.methodInfos)
+	{
+		bool isGetter = (methodInfo.flags & (int)MethodFlags::PropertyGetter) != 0;
+		bool isSetter = (methodInfo.flags & (int)MethodFlags::PropertySetter) != 0;
+
+		if (!isGetter && !isSetter)
+			continue;
+
+		const std::string& type = isGetter ? methodInfo.returnInfo.typeName : methodInfo.paramInfos[0].typeName;
+		bool isStatic = (methodInfo.flags & (int)MethodFlags::Static);
+
+		auto iterFind = propertyLookup.find(methodInfo.scriptName);
+		if (iterFind == propertyLookup.end())
+		{
+			propertyLookup[methodInfo.scriptName] = (int)classInfo.propertyInfos.size();
+
+			PropertyInfo propertyInfo;
+			propertyInfo.name = methodInfo.scriptName;
+			propertyInfo.documentation = std::move(methodInfo.documentation);
+			propertyInfo.isStatic = isStatic;
+			propertyInfo.visibility = methodInfo.visibility;
+			propertyInfo.api = methodInfo.api;
+			propertyInfo.style = std::move(methodInfo.style);
+			propertyInfo.type = type;
+
+			if (isGetter)
+			{
+				propertyInfo.getter = methodInfo.interopName;
+				propertyInfo.typeFlags = methodInfo.returnInfo.flags;
+			}
+			else // Setter
+			{
+				propertyInfo.setter = methodInfo.interopName;
+				propertyInfo.typeFlags = methodInfo.paramInfos[0].flags;
+			}
+
+			classInfo.propertyInfos.push_back(std::move(propertyInfo));
+		}
+		else
+		{
+			PropertyInfo& existingInfo = classInfo.propertyInfos[iterFind->second];
+			if (existingInfo.type != type || existingInfo.isStatic != isStatic)
+			{
+				log << "Error: Getter and setter types for the property \"" << methodInfo.scriptName << "\" don't match. Skipping property.\n";
+				continue;
+			}
+
+			if (isGetter)
+			{
+				existingInfo.getter = methodInfo.interopName;
+
+				// Prefer documentation from setter, but use getter if no other available
+				if (existingInfo.documentation.brief.empty())
+					existingInfo.documentation = std::move(methodInfo.documentation);
+			}
+			else
+			{
+				existingInfo.setter = methodInfo.interopName;
+				existingInfo.style = std::move(methodInfo.style); // Always prefer style flags from the setter
+
+				if (!methodInfo.documentation.brief.empty())
+					existingInfo.documentation = std::move(methodInfo.documentation);
 			}
 		}
 	}
+}
 
-	// Generate meta-data about base classes
-	for (auto& fileInfo : outputFileInfos)
+/** 
+ * Generates meta-data about base classes and builds the class hierarchy. 
+ *
+ * Reads: base classes of classes in all files. Writes: class flags in any file, the class hierarchy.
+ */
+void generateBaseClassInfos(const std::vector<OutputFileEntry*>& files, const OutputInfoLookup& lookup)
+{
+	for (auto& fileInfo : files)
 	{
-		for (auto& classInfo : fileInfo.second.classInfos)
+		for (auto& classInfo : fileInfo->second.classInfos)
 		{
 			if (classInfo.baseClass.empty())
 				continue;
 
 			bool isEditor = hasAPIBED(classInfo.api);
-			ClassInfo* baseClassInfo = findClassInfo(classInfo.baseClass, isEditor);
+			ClassInfo* baseClassInfo = lookup.findClassInfo(classInfo.baseClass, isEditor);
 			if (baseClassInfo == nullptr)
 			{
 				assert(false);
@@ -1412,11 +1829,20 @@ void postProcessFileInfos()
 			}
 
 			baseClassInfo->flags |= (int)ClassFlags::IsBase;
-			baseClassLookup[baseClassInfo->name].childClasses.push_back(classInfo.name);
+			classHierarchy.addDerivedClass(baseClassInfo->name, classInfo.name);
 		}
 	}
 
-	// Properly generate enum default values
+	classHierarchy.build();
+}
+
+/** 
+ * Maps enum default values of all parameters and fields in the file to script enum entries. 
+ *
+ * Reads: enums in all files. Writes: parameters and fields in the provided file.
+ */
+void mapEnumDefaultValues(FileInfo& fileInfo, const OutputInfoLookup& lookup, raw_ostream& log)
+{
 	auto parseDefaultValue = [&](VarInfo& paramInfo)
 	{
 		if (paramInfo.defaultValue.empty())
@@ -1428,10 +1854,10 @@ void postProcessFileInfos()
 			return;
 
 		int enumIdx = atoi(paramInfo.defaultValue.c_str());
-		EnumInfo* enumInfo = findEnumInfo(paramInfo.typeName);
+		EnumInfo* enumInfo = lookup.findEnumInfo(paramInfo.typeName);
 		if(enumInfo == nullptr)
 		{
-			outs() << "Error: Cannot map default value of \"" + paramInfo.name + 
+			log << "Error: Cannot map default value of \"" + paramInfo.name + 
 				"\" to enum entry for enum type \"" + paramInfo.typeName + "\". Ignoring.";
 			paramInfo.defaultValue = "";
 			return;
@@ -1440,7 +1866,7 @@ void postProcessFileInfos()
 		auto iterFind = enumInfo->entries.find(enumIdx);
 		if(iterFind == enumInfo->entries.end())
 		{
-			outs() << "Error: Cannot map default value of \"" + paramInfo.name + 
+			log << "Error: Cannot map default value of \"" + paramInfo.name + 
 				"\" to enum entry for enum type \"" + paramInfo.typeName + "\". Ignoring.";
 			paramInfo.defaultValue = "";
 			return;
@@ -1449,304 +1875,632 @@ void postProcessFileInfos()
 		paramInfo.defaultValue = enumInfo->scriptName + "." + iterFind->second.scriptName;
 	};
 
-	for (auto& fileInfo : outputFileInfos)
+	for (auto& classInfo : fileInfo.classInfos)
 	{
-		for (auto& classInfo : fileInfo.second.classInfos)
+		for(auto& methodInfo : classInfo.methodInfos)
 		{
-			for(auto& methodInfo : classInfo.methodInfos)
-			{
-				for (auto& paramInfo : methodInfo.paramInfos)
-					parseDefaultValue(paramInfo);
-			}
-
-			for (auto& ctorInfo : classInfo.ctorInfos)
-			{
-				for (auto& paramInfo : ctorInfo.paramInfos)
-					parseDefaultValue(paramInfo);
-			}
+			for (auto& paramInfo : methodInfo.paramInfos)
+				parseDefaultValue(paramInfo);
 		}
 
-		for(auto& structInfo : fileInfo.second.structInfos)
+		for (auto& ctorInfo : classInfo.ctorInfos)
 		{
-			for(auto& fieldInfo : structInfo.fields)
-				parseDefaultValue(fieldInfo);
+			for (auto& paramInfo : ctorInfo.paramInfos)
+				parseDefaultValue(paramInfo);
+		}
+	}
 
-			for (auto& ctorInfo : structInfo.ctors)
-			{
-				for (auto& paramInfo : ctorInfo.params)
-					parseDefaultValue(paramInfo);
-			}
+	for(auto& structInfo : fileInfo.structInfos)
+	{
+		for(auto& fieldInfo : structInfo.fields)
+			parseDefaultValue(fieldInfo);
+
+		for (auto& ctorInfo : structInfo.ctors)
+		{
+			for (auto& paramInfo : ctorInfo.params)
+				parseDefaultValue(paramInfo);
 		}
 	}
+}
 
-	// Find structs requiring special conversion
-	for (auto& fileInfo : outputFileInfos)
+/** 
+ * Finds structs requiring special conversion. 
+ *
+ * Reads and writes: structs in the provided file.
+ */
+void findComplexStructs(FileInfo& fileInfo)
+{
+	for (auto& structInfo : fileInfo.structInfos)
 	{
-		for (auto& structInfo : fileInfo.second.structInfos)
+		for(auto& fieldInfo : structInfo.fields)
 		{
-			for(auto& fieldInfo : structInfo.fields)
-			{
-				UserTypeInfo typeInfo = getTypeInfo(fieldInfo.typeName, fieldInfo.flags);
+			UserTypeInfo typeInfo = getTypeInfo(fieldInfo.typeName, fieldInfo.flags);
 
-				if(isArrayOrVector(fieldInfo.flags) || !(typeInfo.type == ParsedType::Builtin || typeInfo.type == ParsedType::Enum))
-				{
-					structInfo.requiresInterop = true;
-					break;
-				}
+			if(isArrayOrVector(fieldInfo.flags) || !(typeInfo.type == ParsedType::Builtin || typeInfo.type == ParsedType::Enum))
+			{
+				structInfo.requiresInterop = true;
+				break;
 			}
-
-			if (structInfo.requiresInterop)
-				structInfo.interopName = getStructInteropType(structInfo.name);
-			else
-				structInfo.interopName = structInfo.name;
 		}
+
+		if (structInfo.requiresInterop)
+			structInfo.interopName = getStructInteropType(structInfo.name);
+		else
+			structInfo.interopName = structInfo.name;
 	}
+}
 
-	// Mark parameters referencing complex structs and base types
-	for (auto& fileInfo : outputFileInfos)
+/** 
+ * Marks parameters referencing complex structs and base types. 
+ *
+ * Reads: structs and class flags in all files. Writes: parameters and fields in the provided file.
+ */
+void markComplexAndBaseTypes(FileInfo& fileInfo, const OutputInfoLookup& lookup)
+{
+	auto markComplexType = [&lookup](const std::string& type, int& flags)
 	{
-		auto markComplexType = [](const std::string& type, int& flags)
-		{
-			UserTypeInfo typeInfo = getTypeInfo(type, flags);
-			if (typeInfo.type != ParsedType::Struct)
-				return;
-
-			StructInfo* structInfo = findStructInfo(type);
-			if (structInfo != nullptr && structInfo->requiresInterop)
-				flags |= (int)TypeFlags::ComplexStruct;
-		};
+		UserTypeInfo typeInfo = getTypeInfo(type, flags);
+		if (typeInfo.type != ParsedType::Struct)
+			return;
 
-		auto markBaseType = [&findClassInfo](const std::string& type, int& flags)
-		{
-			UserTypeInfo typeInfo = getTypeInfo(type, flags);
-			if (typeInfo.type != ParsedType::Class && typeInfo.type != ParsedType::ReflectableClass && 
-				typeInfo.type != ParsedType::GUIElement && !isHandleType(typeInfo.type))
-				return;
+		StructInfo* structInfo = lookup.findStructInfo(type);
+		if (structInfo != nullptr && structInfo->requiresInterop)
+			flags |= (int)TypeFlags::ComplexStruct;
+	};
 
-			ClassInfo* classInfo = findClassInfo(type, false);
-			if (classInfo != nullptr)
-			{
-				bool isBase = (classInfo->flags & (int)ClassFlags::IsBase) != 0;
-				if (isBase)
-					flags |= (int)TypeFlags::ReferencesBase;
-			}
-		};
+	auto markBaseType = [&lookup](const std::string& type, int& flags)
+	{
+		UserTypeInfo typeInfo = getTypeInfo(type, flags);
+		if (typeInfo.type != ParsedType::Class && typeInfo.type != ParsedType::ReflectableClass && 
+			typeInfo.type != ParsedType::GUIElement && !isHandleType(typeInfo.type))
+			return;
 
-		auto markParam = [&markComplexType,&markBaseType](VarInfo& paramInfo)
+		ClassInfo* classInfo = lookup.findClassInfo(type, false);
+		if (classInfo != nullptr)
 		{
-			markComplexType(paramInfo.typeName, paramInfo.flags);
-			markBaseType(paramInfo.typeName, paramInfo.flags);
-		};
+			bool isBase = (classInfo->flags & (int)ClassFlags::IsBase) != 0;
+			if (isBase)
+				flags |= (int)TypeFlags::ReferencesBase;
+		}
+	};
 
-		for (auto& classInfo : fileInfo.second.classInfos)
-		{
-			for(auto& methodInfo : classInfo.methodInfos)
-			{
-				for (auto& paramInfo : methodInfo.paramInfos)
-					markParam(paramInfo);
+	auto markParam = [&markComplexType,&markBaseType](VarInfo& paramInfo)
+	{
+		markComplexType(paramInfo.typeName, paramInfo.flags);
+		markBaseType(paramInfo.typeName, paramInfo.flags);
+	};
 
-				if (methodInfo.returnInfo.typeName.size() != 0)
-				{
-					markComplexType(methodInfo.returnInfo.typeName, methodInfo.returnInfo.flags);
-					markBaseType(methodInfo.returnInfo.typeName, methodInfo.returnInfo.flags);
-				}
-			}
+	for (auto& classInfo : fileInfo.classInfos)
+	{
+		for(auto& methodInfo : classInfo.methodInfos)
+		{
+			for (auto& paramInfo : methodInfo.paramInfos)
+				markParam(paramInfo);
 
-			for (auto& eventInfo : classInfo.eventInfos)
+			if (methodInfo.returnInfo.typeName.size() != 0)
 			{
-				for (auto& paramInfo : eventInfo.paramInfos)
-					markParam(paramInfo);
+				markComplexType(methodInfo.returnInfo.typeName, methodInfo.returnInfo.flags);
+				markBaseType(methodInfo.returnInfo.typeName, methodInfo.returnInfo.flags);
 			}
+		}
 
-			for (auto& ctorInfo : classInfo.ctorInfos)
-			{
-				for (auto& paramInfo : ctorInfo.paramInfos)
-					markParam(paramInfo);
-			}
+		for (auto& eventInfo : classInfo.eventInfos)
+		{
+			for (auto& paramInfo : eventInfo.paramInfos)
+				markParam(paramInfo);
 		}
 
-		for(auto& structInfo : fileInfo.second.structInfos)
+		for (auto& ctorInfo : classInfo.ctorInfos)
 		{
-			for(auto& fieldInfo : structInfo.fields)
-			{
-				markComplexType(fieldInfo.typeName, fieldInfo.flags);
-				markParam(fieldInfo);
-			}
+			for (auto& paramInfo : ctorInfo.paramInfos)
+				markParam(paramInfo);
 		}
 	}
 
-	// Generate referenced includes
+	for(auto& structInfo : fileInfo.structInfos)
 	{
-		for (auto& fileInfo : outputFileInfos)
+		for(auto& fieldInfo : structInfo.fields)
 		{
-			IncludesInfo includesInfo;
-			for (auto& classInfo : fileInfo.second.classInfos)
-				gatherIncludes(classInfo, includesInfo);
+			markComplexType(fieldInfo.typeName, fieldInfo.flags);
+			markParam(fieldInfo);
+		}
+	}
+}
 
-			for (auto& structInfo : fileInfo.second.structInfos)
-				gatherIncludes(structInfo, includesInfo);
+/** Number of includes referenced by a generated file, before and after removing redundant includes. */
+struct IncludeCounts
+{
+	int numHeaderIncludes = 0;
+	int numSourceIncludes = 0;
+	int numRawHeaderIncludes = 0;
+	int numRawSourceIncludes = 0;
+};
 
-			// Needed for all .h files
-			if (!fileInfo.second.inEditor)
-				fileInfo.second.referencedHeaderIncludes.push_back("BsScriptEnginePrerequisites.h");
-			else
-				fileInfo.second.referencedHeaderIncludes.push_back("BsScriptEditorPrerequisites.h");
+/** 
+ * Checks can the provided parameter be passed to native code as a view over the managed array memory. This requires
+ * an input vector whose elements have the same memory layout in managed and native code.
+ */
+bool canBePassedAsSpan(const VarTypeInfo& varTypeInfo)
+{
+	if (!isVector(varTypeInfo.flags) || isOutput(varTypeInfo.flags) || getIsAsyncOp(varTypeInfo.flags))
+		return false;
+
+	UserTypeInfo typeInfo = getTypeInfo(varTypeInfo.typeName, varTypeInfo.flags);
+	switch (typeInfo.type)
+	{
+	case ParsedType::Builtin:
+	case ParsedType::Enum:
+		return true;
+	case ParsedType::Struct:
+		return !isComplexStruct(varTypeInfo.flags);
+	default:
+		return false;
+	}
+}
 
-			// Needed for all .cpp files
-			fileInfo.second.referencedSourceIncludes.push_back("BsScript" + fileInfo.first + ".generated.h");
-			fileInfo.second.referencedSourceIncludes.push_back("BsMonoMethod.h");
-			fileInfo.second.referencedSourceIncludes.push_back("BsMonoClass.h");
-			fileInfo.second.referencedSourceIncludes.push_back("BsMonoUtil.h");
+/** 
+ * Ensures all parameters marked with the "span" annotation can actually be passed as spans, and removes the annotation
+ * from those that cannot (in which case they are passed by copy as usual).
+ */
+void validateSpanParams(FileInfo& fileInfo, raw_ostream& log)
+{
+	auto validateParams = [&log](const ClassInfo& classInfo, MethodInfo& methodInfo, bool allowed)
+	{
+		for (auto& paramInfo : methodInfo.paramInfos)
+		{
+			if (!isSpan(paramInfo.flags))
+				continue;
 
-			for (auto& classInfo : fileInfo.second.classInfos)
+			if (!allowed || !canBePassedAsSpan(paramInfo))
 			{
-				UserTypeInfo& typeInfo = cppToCsTypeMap[classInfo.name];
+				log << "Warning: Parameter \"" << paramInfo.name << "\" of method \"" << classInfo.name << "::" << 
+					methodInfo.sourceName << "\" cannot be passed as a span. Only input vectors of builtin, enum or " <<
+					"simple struct types are supported. Passing it by copy instead.\n";
 
-				fileInfo.second.forwardDeclarations.insert({ classInfo.ns, classInfo.cleanName, isStruct(classInfo.flags), classInfo.templParams });
-
-				if (typeInfo.type == ParsedType::Resource)
-					fileInfo.second.referencedHeaderIncludes.push_back("Wrappers/BsScriptResource.h");
-				else if (typeInfo.type == ParsedType::Component)
-					fileInfo.second.referencedHeaderIncludes.push_back("Wrappers/BsScriptComponent.h");
-				else if (typeInfo.type == ParsedType::SceneObject)
-					fileInfo.second.referencedHeaderIncludes.push_back("Wrappers/BsScriptSceneObject.h");
-				else if (typeInfo.type == ParsedType::GUIElement)
-					fileInfo.second.referencedHeaderIncludes.push_back("Wrappers/GUI/BsScriptGUIElement.h");
-				else if (typeInfo.type == ParsedType::ReflectableClass)
-					fileInfo.second.referencedHeaderIncludes.push_back("Wrappers/BsScriptReflectable.h");
-				else // Class
-					fileInfo.second.referencedHeaderIncludes.push_back("BsScriptObject.h");
-
-				if (!classInfo.baseClass.empty())
-				{
-					UserTypeInfo& baseTypeInfo = cppToCsTypeMap[classInfo.baseClass];
+				paramInfo.flags &= ~(int)TypeFlags::Span;
+			}
+		}
+	};
 
-					if(hasAPIBED(classInfo.api))
-						fileInfo.second.referencedHeaderIncludes.push_back(baseTypeInfo.destFileEditor);
-					else
-						fileInfo.second.referencedHeaderIncludes.push_back(baseTypeInfo.destFile);
-				}
+	for (auto& classInfo : fileInfo.classInfos)
+	{
+		for (auto& methodInfo : classInfo.ctorInfos)
+			validateParams(classInfo, methodInfo, true);
 
-				if (typeInfo.type != ParsedType::ReflectableClass && classInfo.templParams.empty())
-					fileInfo.second.referencedSourceIncludes.push_back(typeInfo.declFile);
-				else
-				{
-					// Templated classes need to be included in header, so the linker doesn't instantiate them multiple times for different libraries
-					// (in case template is exported).
-					// Reflectable classes need to be included in the header because they provide a getInternal<T>() method
-					// which requires information about T.
-					fileInfo.second.referencedHeaderIncludes.push_back(typeInfo.declFile);
-				}
-			}
+		for (auto& methodInfo : classInfo.methodInfos)
+			validateParams(classInfo, methodInfo, !isCSOnly(methodInfo.flags));
 
-			for(auto& structInfo : fileInfo.second.structInfos)
-			{
-				UserTypeInfo& typeInfo = cppToCsTypeMap[structInfo.name];
+		for (auto& eventInfo : classInfo.eventInfos)
+			validateParams(classInfo, eventInfo, false);
+	}
+}
 
-				fileInfo.second.referencedHeaderIncludes.push_back("BsScriptObject.h");
-				fileInfo.second.referencedHeaderIncludes.push_back(typeInfo.declFile);
-			}
+/** 
+ * Checks can the provided event parameter be stored in the queue of a deferred event, and delivered to managed code as
+ * an array with an entry per event fire.
+ */
+bool canBeDeferred(const VarTypeInfo& varTypeInfo)
+{
+	if (isArrayOrVector(varTypeInfo.flags) || isOutput(varTypeInfo.flags) || getIsAsyncOp(varTypeInfo.flags) || 
+		isSrcPointer(varTypeInfo.flags))
+		return false;
 
-			if(includesInfo.requiresResourceManager)
-				fileInfo.second.referencedSourceIncludes.push_back("BsScriptResourceManager.h");
+	UserTypeInfo typeInfo = getTypeInfo(varTypeInfo.typeName, varTypeInfo.flags);
+	switch (typeInfo.type)
+	{
+	case ParsedType::Builtin:
+	case ParsedType::Enum:
+	case ParsedType::String:
+	case ParsedType::WString:
+	case ParsedType::Path:
+	case ParsedType::Struct:
+		return true;
+	default:
+		return false;
+	}
+}
 
-			if (includesInfo.requiresRRef)
-				fileInfo.second.referencedSourceIncludes.push_back("Wrappers/BsScriptRRefBase.h");
+/** 
+ * Ensures all events marked as deferred can actually be queued, and removes the flag from those that cannot (in which
+ * case they are delivered immediately as usual). Only static and module events are supported, as the queue is shared
+ * by all fires of the event.
+ */
+void validateDeferredEvents(FileInfo& fileInfo, raw_ostream& log)
+{
+	for (auto& classInfo : fileInfo.classInfos)
+	{
+		bool isModule = (classInfo.flags & (int)ClassFlags::IsModule) != 0;
 
-			if (includesInfo.requiresAsyncOp)
-				fileInfo.second.referencedSourceIncludes.push_back("Wrappers/BsScriptAsyncOp.h");
+		for (auto& eventInfo : classInfo.eventInfos)
+		{
+			if (!isDeferred(eventInfo.flags))
+				continue;
 
-			if(includesInfo.requiresGameObjectManager)
-				fileInfo.second.referencedSourceIncludes.push_back("BsScriptGameObjectManager.h");
+			bool isStatic = (eventInfo.flags & (int)MethodFlags::Static) != 0;
+			bool isCallback = (eventInfo.flags & (int)MethodFlags::Callback) != 0;
 
-			if(includesInfo.requiresRTTI)
-				fileInfo.second.referencedSourceIncludes.push_back("Reflection/BsRTTIType.h");
+			bool isValid = !isCallback && (isStatic || isModule);
+			for (auto& paramInfo : eventInfo.paramInfos)
+				isValid &= canBeDeferred(paramInfo);
 
-			for (auto& entry : includesInfo.includes)
+			if (!isValid)
 			{
-				uint32_t originFlags = entry.second.originIncludeFlags;
-				uint32_t interopFlags = entry.second.interopIncludeFlags;
+				log << "Warning: Event \"" << classInfo.name << "::" << eventInfo.sourceName << "\" cannot be deferred. " << 
+					"Only static or module events with builtin, enum, string or struct parameters are supported. " <<
+					"Delivering it immediately instead.\n";
 
-				if (originFlags != 0)
-				{
-					std::string include = entry.second.typeInfo.declFile;
-
-					if ((originFlags & IT_FWD) != 0)
-						fileInfo.second.forwardDeclarations.insert({ entry.second.typeInfo.ns, entry.second.typeName, entry.second.isStruct });
+				eventInfo.flags &= ~((int)MethodFlags::Deferred | (int)MethodFlags::Coalesced);
+				continue;
+			}
 
-					if((originFlags & IT_IMPL) != 0)
-						fileInfo.second.referencedSourceIncludes.push_back(include);
-					else
-						fileInfo.second.referencedHeaderIncludes.push_back(include);
-				}
+			if (!isCoalesced(eventInfo.flags))
+				continue;
 
-				if (interopFlags != 0)
+			// Structs don't necessarily provide a comparison operator
+			for (auto& paramInfo : eventInfo.paramInfos)
+			{
+				UserTypeInfo paramTypeInfo = getTypeInfo(paramInfo.typeName, paramInfo.flags);
+				if (paramTypeInfo.type == ParsedType::Struct)
 				{
-					std::string include;
-					if(entry.second.isEditor)
-						include = entry.second.typeInfo.destFileEditor;
-					else
-						include = entry.second.typeInfo.destFile;
-
-					if ((interopFlags & IT_FWD) != 0)
-					{
-						if(entry.second.isEditor)
-							fileInfo.second.forwardDeclarations.insert({ entry.second.typeInfo.ns, entry.second.typeName, false });
-					}
+					log << "Warning: Event \"" << classInfo.name << "::" << eventInfo.sourceName << "\" cannot be " <<
+						"coalesced because it has struct parameters. Queuing every fire instead.\n";
 
-					if(!include.empty())
-					{
-						if ((interopFlags & IT_IMPL) != 0)
-							fileInfo.second.referencedSourceIncludes.push_back(include);
-						else
-							fileInfo.second.referencedHeaderIncludes.push_back(include);
-					}
+					eventInfo.flags &= ~(int)MethodFlags::Coalesced;
+					break;
 				}
 			}
-
-			for (auto& entry : includesInfo.fwdDecls)
-				fileInfo.second.forwardDeclarations.insert(entry.second);
 		}
 	}
+}
 
-	// Generate overloads for unsupported default parameters
-	for (auto& fileInfo : outputFileInfos)
-	{
-		for (auto& classInfo : fileInfo.second.classInfos)
-		{
-			std::vector<MethodInfo> newMethodInfos;
-			for (auto& methodInfo : classInfo.methodInfos)
-				handleDefaultParams(methodInfo, newMethodInfos);
+/** 
+ * Returns the signature used for delivering the queued fires of a deferred event to managed code. The signature starts
+ * with the number of queued fires, followed by each of the event parameters as an array with an entry per fire.
+ */
+MethodInfo getDeferredEventInfo(const MethodInfo& eventInfo)
+{
+	MethodInfo output = eventInfo;
+	output.flags &= ~((int)MethodFlags::Deferred | (int)MethodFlags::Coalesced);
+	output.paramInfos.clear();
 
-			for (auto& methodInfo : newMethodInfos)
-				classInfo.methodInfos.push_back(methodInfo);
+	VarInfo countInfo;
+	countInfo.name = "count";
+	countInfo.typeName = "int32_t";
+	countInfo.flags = (int)TypeFlags::Builtin;
+	output.paramInfos.push_back(countInfo);
 
-			std::vector<MethodInfo> newCtorInfos;
-			for (auto& ctorInfo : classInfo.ctorInfos)
-				handleDefaultParams(ctorInfo, newCtorInfos);
+	for (auto& paramInfo : eventInfo.paramInfos)
+	{
+		VarInfo deferredParamInfo = paramInfo;
+		deferredParamInfo.flags &= ~(int)TypeFlags::SrcRef;
+		deferredParamInfo.flags |= (int)TypeFlags::Vector;
 
-			for (auto& ctorInfo : newCtorInfos)
-				classInfo.ctorInfos.push_back(ctorInfo);
-		}
+		output.paramInfos.push_back(deferredParamInfo);
 	}
+
+	return output;
 }
 
-std::string generateFileHeader(bool isBanshee)
+/** Removes empty and duplicate entries from the list of includes, as well as any entries present in @p excluded. */
+void removeRedundantIncludes(std::vector<std::string>& includes, ArrayRef<std::string> excluded)
 {
-	std::stringstream output;
-	if (isBanshee)
-		output << sEditorCopyrightNotice;
-	else
-		output << sFrameworkCopyrightNotice;
+	std::unordered_set<std::string> usedIncludes(excluded.begin(), excluded.end());
 
-	return output.str();
+	int numIncludes = 0;
+	for (auto& entry : includes)
+	{
+		if (entry.empty() || !usedIncludes.insert(entry).second)
+			continue;
+
+		includes[numIncludes++] = entry;
+	}
+
+	includes.resize(numIncludes);
 }
 
-std::string generateCppApiCheckBegin(ApiFlags api)
+/** 
+ * Generates a minimal list of includes and forward declarations required by the file. Full includes are placed in the
+ * source file whenever the generated header can make do with a forward declaration.
+ *
+ * Reads: the provided file, type infos of all referenced types. Writes: includes and forward declarations in the file.
+ */
+IncludeCounts generateReferencedIncludes(const std::string& fileName, FileInfo& fileInfo)
 {
-	if(api == ApiFlags::BSF)
-		return "#if !BS_IS_BANSHEE3D\n";
-	else if(api == ApiFlags::B3D)
+	// Note: Not using operator[] as this can run in parallel for multiple files
+	auto findTypeInfo = [](const std::string& name) -> const UserTypeInfo&
+	{
+		static const UserTypeInfo EMPTY_TYPE_INFO = UserTypeInfo();
+
+		auto iterFind = cppToCsTypeMap.find(name);
+		if (iterFind == cppToCsTypeMap.end())
+			return EMPTY_TYPE_INFO;
+
+		return iterFind->second;
+	};
+
+	IncludesInfo includesInfo;
+	for (auto& classInfo : fileInfo.classInfos)
+		gatherIncludes(classInfo, includesInfo);
+
+	for (auto& structInfo : fileInfo.structInfos)
+		gatherIncludes(structInfo, includesInfo);
+
+	// Needed for all .h files
+	if (!fileInfo.inEditor)
+		fileInfo.referencedHeaderIncludes.push_back("BsScriptEnginePrerequisites.h");
+	else
+		fileInfo.referencedHeaderIncludes.push_back("BsScriptEditorPrerequisites.h");
+
+	// Needed for all .cpp files
+	fileInfo.referencedSourceIncludes.push_back("BsScript" + fileName + ".generated.h");
+	fileInfo.referencedSourceIncludes.push_back("BsMonoMethod.h");
+	fileInfo.referencedSourceIncludes.push_back("BsMonoClass.h");
+	fileInfo.referencedSourceIncludes.push_back("BsMonoUtil.h");
+
+	for (auto& classInfo : fileInfo.classInfos)
+	{
+		const UserTypeInfo& typeInfo = findTypeInfo(classInfo.name);
+
+		fileInfo.forwardDeclarations.insert({ classInfo.ns, classInfo.cleanName, isStruct(classInfo.flags), classInfo.templParams });
+
+		if (typeInfo.type == ParsedType::Resource)
+			fileInfo.referencedHeaderIncludes.push_back("Wrappers/BsScriptResource.h");
+		else if (typeInfo.type == ParsedType::Component)
+			fileInfo.referencedHeaderIncludes.push_back("Wrappers/BsScriptComponent.h");
+		else if (typeInfo.type == ParsedType::SceneObject)
+			fileInfo.referencedHeaderIncludes.push_back("Wrappers/BsScriptSceneObject.h");
+		else if (typeInfo.type == ParsedType::GUIElement)
+			fileInfo.referencedHeaderIncludes.push_back("Wrappers/GUI/BsScriptGUIElement.h");
+		else if (typeInfo.type == ParsedType::ReflectableClass)
+			fileInfo.referencedHeaderIncludes.push_back("Wrappers/BsScriptReflectable.h");
+		else // Class
+			fileInfo.referencedHeaderIncludes.push_back("BsScriptObject.h");
+
+		bool isModule = (classInfo.flags & (int)ClassFlags::IsModule) != 0;
+		if (usesPooledWrapperAllocation(typeInfo.type, isModule))
+			fileInfo.referencedHeaderIncludes.push_back("Allocators/BsPoolAlloc.h");
+
+		if (!classInfo.baseClass.empty())
+		{
+			const UserTypeInfo& baseTypeInfo = findTypeInfo(classInfo.baseClass);
+
+			if(hasAPIBED(classInfo.api))
+				fileInfo.referencedHeaderIncludes.push_back(baseTypeInfo.destFileEditor);
+			else
+				fileInfo.referencedHeaderIncludes.push_back(baseTypeInfo.destFile);
+		}
+
+		if (typeInfo.type != ParsedType::ReflectableClass && classInfo.templParams.empty())
+			fileInfo.referencedSourceIncludes.push_back(typeInfo.declFile);
+		else
+		{
+			// Templated classes need to be included in header, so the linker doesn't instantiate them multiple times for different libraries
+			// (in case template is exported).
+			// Reflectable classes need to be included in the header because they provide a getInternal<T>() method
+			// which requires information about T.
+			fileInfo.referencedHeaderIncludes.push_back(typeInfo.declFile);
+		}
+	}
+
+	for(auto& structInfo : fileInfo.structInfos)
+	{
+		const UserTypeInfo& typeInfo = findTypeInfo(structInfo.name);
+
+		fileInfo.referencedHeaderIncludes.push_back("BsScriptObject.h");
+
+		// Header only declares methods accepting or returning the struct, so a forward declaration is enough. Templated
+		// structs still need to be included for the same reason as templated classes above.
+		if (structInfo.templParams.empty() && !structInfo.isTemplateInst)
+		{
+			fileInfo.forwardDeclarations.insert({ structInfo.ns, structInfo.cleanName, structInfo.isStruct });
+			fileInfo.referencedSourceIncludes.push_back(typeInfo.declFile);
+		}
+		else
+			fileInfo.referencedHeaderIncludes.push_back(typeInfo.declFile);
+	}
+
+	if(includesInfo.requiresResourceManager)
+		fileInfo.referencedSourceIncludes.push_back("BsScriptResourceManager.h");
+
+	if (includesInfo.requiresRRef)
+		fileInfo.referencedSourceIncludes.push_back("Wrappers/BsScriptRRefBase.h");
+
+	if (includesInfo.requiresAsyncOp)
+		fileInfo.referencedSourceIncludes.push_back("Wrappers/BsScriptAsyncOp.h");
+
+	if(includesInfo.requiresGameObjectManager)
+		fileInfo.referencedSourceIncludes.push_back("BsScriptGameObjectManager.h");
+
+	if(includesInfo.requiresRTTI)
+		fileInfo.referencedSourceIncludes.push_back("Reflection/BsRTTIType.h");
+
+	for (auto& entry : includesInfo.includes)
+	{
+		uint32_t originFlags = entry.second.originIncludeFlags;
+		uint32_t interopFlags = entry.second.interopIncludeFlags;
+
+		if (originFlags != 0)
+		{
+			std::string include = entry.second.typeInfo.declFile;
+
+			if ((originFlags & IT_FWD) != 0)
+				fileInfo.forwardDeclarations.insert({ entry.second.typeInfo.ns, entry.second.typeName, entry.second.isStruct });
+
+			if((originFlags & IT_IMPL) != 0)
+				fileInfo.referencedSourceIncludes.push_back(include);
+			else
+				fileInfo.referencedHeaderIncludes.push_back(include);
+		}
+
+		if (interopFlags != 0)
+		{
+			std::string include;
+			if(entry.second.isEditor)
+				include = entry.second.typeInfo.destFileEditor;
+			else
+				include = entry.second.typeInfo.destFile;
+
+			if ((interopFlags & IT_FWD) != 0)
+			{
+				if(entry.second.isEditor)
+					fileInfo.forwardDeclarations.insert({ entry.second.typeInfo.ns, entry.second.typeName, false });
+			}
+
+			if(!include.empty())
+			{
+				if ((interopFlags & IT_IMPL) != 0)
+					fileInfo.referencedSourceIncludes.push_back(include);
+				else
+					fileInfo.referencedHeaderIncludes.push_back(include);
+			}
+		}
+	}
+
+	for (auto& entry : includesInfo.fwdDecls)
+		fileInfo.forwardDeclarations.insert(entry.second);
+
+	IncludeCounts counts;
+	counts.numRawHeaderIncludes = (int)fileInfo.referencedHeaderIncludes.size();
+	counts.numRawSourceIncludes = (int)fileInfo.referencedSourceIncludes.size();
+
+	// Source file includes the header, so anything included there doesn't need to be included again
+	removeRedundantIncludes(fileInfo.referencedHeaderIncludes, {});
+	removeRedundantIncludes(fileInfo.referencedSourceIncludes, fileInfo.referencedHeaderIncludes);
+
+	counts.numHeaderIncludes = (int)fileInfo.referencedHeaderIncludes.size();
+	counts.numSourceIncludes = (int)fileInfo.referencedSourceIncludes.size();
+
+	return counts;
+}
+
+/** Outputs the number of includes referenced by the generated files, and the headers included by most generated headers. */
+void reportIncludes(ArrayRef<IncludeCounts> counts)
+{
+	IncludeCounts total;
+	for (auto& entry : counts)
+	{
+		total.numHeaderIncludes += entry.numHeaderIncludes;
+		total.numSourceIncludes += entry.numSourceIncludes;
+		total.numRawHeaderIncludes += entry.numRawHeaderIncludes;
+		total.numRawSourceIncludes += entry.numRawSourceIncludes;
+	}
+
+	outs() << "Includes in generated headers: " << total.numHeaderIncludes << " (" << total.numRawHeaderIncludes 
+		<< " before removing duplicates)\n";
+	outs() << "Includes in generated sources: " << total.numSourceIncludes << " (" << total.numRawSourceIncludes 
+		<< " before removing duplicates)\n";
+
+	// Fan-in: number of generated headers including a particular header. Every file including one of those generated
+	// headers pays for the include as well, so these are the most important to keep small.
+	std::map<std::string, int> fanIn;
+	for (auto& fileInfo : outputFileInfos)
+	{
+		for (auto& include : fileInfo.second.referencedHeaderIncludes)
+			fanIn[include]++;
+	}
+
+	std::vector<std::pair<std::string, int>> sortedFanIn(fanIn.begin(), fanIn.end());
+	std::stable_sort(sortedFanIn.begin(), sortedFanIn.end(), 
+		[](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b)
+	{
+		return a.second > b.second;
+	});
+
+	const int MAX_REPORTED_HEADERS = 20;
+	int numReported = std::min(MAX_REPORTED_HEADERS, (int)sortedFanIn.size());
+
+	outs() << "Headers included by most generated headers:\n";
+	for (int i = 0; i < numReported; i++)
+		outs() << "\t" << sortedFanIn[i].second << "\t" << sortedFanIn[i].first << "\n";
+}
+
+/** 
+ * Generates overloads for unsupported default parameters. 
+ *
+ * Reads and writes: methods and constructors in the provided file.
+ */
+void generateDefaultParamOverloads(FileInfo& fileInfo)
+{
+	for (auto& classInfo : fileInfo.classInfos)
+	{
+		std::vector<MethodInfo> newMethodInfos;
+		for (auto& methodInfo : classInfo.methodInfos)
+			handleDefaultParams(methodInfo, newMethodInfos);
+
+		for (auto& methodInfo : newMethodInfos)
+			classInfo.methodInfos.push_back(methodInfo);
+
+		std::vector<MethodInfo> newCtorInfos;
+		for (auto& ctorInfo : classInfo.ctorInfos)
+			handleDefaultParams(ctorInfo, newCtorInfos);
+
+		for (auto& ctorInfo : newCtorInfos)
+			classInfo.ctorInfos.push_back(ctorInfo);
+	}
+}
+
+/** 
+ * Processes the parsed information before generation. Passes that only touch data of a single file run in parallel
+ * across files, while passes that need information from all files run in between them.
+ */
+void postProcessFileInfos()
+{
+	std::vector<OutputFileEntry*> files;
+	for (auto& fileInfo : outputFileInfos)
+		files.push_back(&fileInfo);
+
+	OutputInfoLookup lookup;
+	injectExternalMethods(lookup);
+	resolveCopydocComments(files);
+
+	forEachFileParallel(files, [&lookup](int idx, OutputFileEntry& file, raw_ostream& log)
+	{
+		for (auto& classInfo : file.second.classInfos)
+		{
+			generateBufferOverloads(classInfo);
+			generateBatchOverloads(classInfo, log);
+			generateInteropNames(classInfo);
+			generatePropertyInfos(classInfo, log);
+		}
+
+		mapEnumDefaultValues(file.second, lookup, log);
+		findComplexStructs(file.second);
+	});
+
+	// Requires all files, modifies classes in other files
+	generateBaseClassInfos(files, lookup);
+
+	// Reads complex struct and base class information from all files
+	std::vector<IncludeCounts> includeCounts(files.size());
+	forEachFileParallel(files, [&lookup, &includeCounts](int idx, OutputFileEntry& file, raw_ostream& log)
+	{
+		markComplexAndBaseTypes(file.second, lookup);
+		validateSpanParams(file.second, log);
+		validateDeferredEvents(file.second, log);
+		includeCounts[idx] = generateReferencedIncludes(file.first, file.second);
+		generateDefaultParamOverloads(file.second);
+	});
+
+	if (sReportIncludes)
+		reportIncludes(includeCounts);
+}
+
+std::string generateFileHeader(bool isBanshee)
+{
+	CodeWriter output;
+	if (isBanshee)
+		output << sEditorCopyrightNotice;
+	else
+		output << sFrameworkCopyrightNotice;
+
+	return output.str();
+}
+
+std::string generateCppApiCheckBegin(ApiFlags api)
+{
+	if(api == ApiFlags::BSF)
+		return "#if !BS_IS_BANSHEE3D\n";
+	else if(api == ApiFlags::B3D)
 		return "#if BS_IS_BANSHEE3D\n";
 
 	return "";
@@ -1775,10 +2529,14 @@ std::string generateCppMethodSignature(const MethodInfo& methodInfo, const std::
 	bool isStatic = (methodInfo.flags & (int)MethodFlags::Static) != 0;
 	bool isCtor = (methodInfo.flags & (int)MethodFlags::Constructor) != 0;
 
-	std::stringstream output;
+	bool isBufferOutput = fillsBuffer(methodInfo.flags);
+
+	CodeWriter output(256);
 
 	bool returnAsParameter = false;
-	if (methodInfo.returnInfo.typeName.empty() || isCtor)
+	if (isBufferOutput)
+		output << "int";
+	else if (methodInfo.returnInfo.typeName.empty() || isCtor)
 		output << "void";
 	else
 	{
@@ -1812,7 +2570,7 @@ std::string generateCppMethodSignature(const MethodInfo& methodInfo, const std::
 	{
 		output << thisPtrType << "* thisPtr";
 
-		if (methodInfo.paramInfos.size() > 0 || returnAsParameter)
+		if (methodInfo.paramInfos.size() > 0 || returnAsParameter || isBufferOutput)
 			output << ", ";
 	}
 
@@ -1822,10 +2580,13 @@ std::string generateCppMethodSignature(const MethodInfo& methodInfo, const std::
 
 		output << getInteropCppVarType(I->typeName, paramTypeInfo.type, I->flags) << " " << I->name;
 
-		if ((I + 1) != methodInfo.paramInfos.end() || returnAsParameter)
+		if ((I + 1) != methodInfo.paramInfos.end() || returnAsParameter || isBufferOutput)
 			output << ", ";
 	}
 
+	if (isBufferOutput)
+		output << "MonoArray** __buffer";
+
 	if (returnAsParameter)
 	{
 		UserTypeInfo returnTypeInfo = getTypeInfo(methodInfo.returnInfo.typeName, methodInfo.returnInfo.flags);
@@ -1838,21 +2599,10 @@ std::string generateCppMethodSignature(const MethodInfo& methodInfo, const std::
 	return output.str();
 }
 
-std::string generateCppEventCallbackSignature(const MethodInfo& eventInfo, const std::string& nestedName, bool isModule)
+/** Generates the parameter list of the callback method triggered by the provided event, without the parentheses. */
+std::string generateCppEventCallbackParams(const MethodInfo& eventInfo)
 {
-	bool isStatic = (eventInfo.flags & (int)MethodFlags::Static) != 0;
-
-	std::stringstream output;
-
-	if ((isStatic || isModule) && nestedName.empty())
-		output << "static ";
-
-	output << "void ";
-	
-	if (!nestedName.empty())
-		output << nestedName << "::";
-	
-	output << eventInfo.interopName << "(";
+	CodeWriter output(256);
 
 	int idx = 0;
 	for (auto I = eventInfo.paramInfos.begin(); I != eventInfo.paramInfos.end(); ++I)
@@ -1894,15 +2644,88 @@ std::string generateCppEventCallbackSignature(const MethodInfo& eventInfo, const
 		idx++;
 	}
 
-	output << ")";
 	return output.str();
 }
 
-std::string generateCppEventThunk(const MethodInfo& eventInfo, bool isModule)
+std::string generateCppEventCallbackSignature(const MethodInfo& eventInfo, const std::string& nestedName, bool isModule)
+{
+	bool isStatic = (eventInfo.flags & (int)MethodFlags::Static) != 0;
+
+	CodeWriter output(256);
+
+	if ((isStatic || isModule) && nestedName.empty())
+		output << "static ";
+
+	output << "void ";
+	
+	if (!nestedName.empty())
+		output << nestedName << "::";
+	
+	output << eventInfo.interopName << "(" << generateCppEventCallbackParams(eventInfo) << ")";
+	return output.str();
+}
+
+/** 
+ * Generates a lambda that forwards the event parameters to the event callback method of the interop object. The lambda 
+ * captures only the interop object pointer, which allows the event to store it inline, without a heap allocation.
+ */
+std::string generateCppEventCallbackLambda(const MethodInfo& eventInfo)
+{
+	CodeWriter output(256);
+	output << "[this](" << generateCppEventCallbackParams(eventInfo) << ") { " << eventInfo.interopName << "(";
+
+	for (int i = 0; i < (int)eventInfo.paramInfos.size(); i++)
+	{
+		output << "p" << i;
+
+		if ((i + 1) < (int)eventInfo.paramInfos.size())
+			output << ", ";
+	}
+
+	output << "); }";
+	return output.str();
+}
+
+/** 
+ * Checks is the provided event parameter passed to the managed thunk through a boxed object that is cached between fires, 
+ * instead of being boxed on every fire. Only applies to plain structs, as interop types of complex structs contain managed
+ * references, which cannot be copied into an existing managed object without a write barrier.
+ */
+bool isCachedEventBoxParam(const VarTypeInfo& paramInfo)
+{
+	if (isArrayOrVector(paramInfo.flags) || isComplexStruct(paramInfo.flags))
+		return false;
+
+	UserTypeInfo paramTypeInfo = getTypeInfo(paramInfo.typeName, paramInfo.flags);
+	return paramTypeInfo.type == ParsedType::Struct;
+}
+
+/** 
+ * Checks does the event have any parameters passed through cached boxed objects. See isCachedEventBoxParam(). 
+ */
+bool hasCachedEventBoxes(const MethodInfo& eventInfo)
+{
+	// Deferred events deliver their struct parameters in arrays
+	if (isDeferred(eventInfo.flags))
+		return false;
+
+	for (auto& paramInfo : eventInfo.paramInfos)
+	{
+		if (isCachedEventBoxParam(paramInfo))
+			return true;
+	}
+
+	return false;
+}
+
+std::string generateCppEventThunk(const MethodInfo& sourceEventInfo, bool isModule)
 {
+	// Deferred events deliver all their queued fires at once
+	MethodInfo eventInfo = isDeferred(sourceEventInfo.flags) ? getDeferredEventInfo(sourceEventInfo) : sourceEventInfo;
+
 	bool isStatic = (eventInfo.flags & (int)MethodFlags::Static) != 0;
 
-	std::stringstream output;
+	CodeWriter output;
 	output << "\t\ttypedef void(BS_THUNKCALL *" << eventInfo.sourceName << "ThunkDef) (";
 	
 	if (!isStatic && !isModule)
@@ -1912,14 +2735,34 @@ std::string generateCppEventThunk(const MethodInfo& eventInfo, bool isModule)
 	{
 		UserTypeInfo paramTypeInfo = getTypeInfo(I->typeName, I->flags);
 
-		if (paramTypeInfo.type == ParsedType::Struct)
+		// Note: Thunks accept all value types boxed, including those passed by "ref"
+		if (paramTypeInfo.type == ParsedType::Struct && !isArrayOrVector(I->flags))
 			output << "MonoObject* " << I-> name << ", ";
 		else
 			output << getInteropCppVarType(I->typeName, paramTypeInfo.type, I->flags) << " " << I->name << ", ";
 	}
 
-	output << "MonoException**);" << std::endl;
-	output << "\t\tstatic " << eventInfo.sourceName << "ThunkDef " << eventInfo.sourceName << "Thunk;" << std::endl;
+	output << "MonoException**);\n";
+
+	// Lazily resolved thunks can be resolved by events triggered from any thread
+	if (sLazyRuntimeData)
+	{
+		output << "\t\tstatic std::atomic<" << eventInfo.sourceName << "ThunkDef> " << eventInfo.sourceName << 
+			"Thunk;\n";
+	}
+	else
+		output << "\t\tstatic " << eventInfo.sourceName << "ThunkDef " << eventInfo.sourceName << "Thunk;\n";
+
+	if (hasCachedEventBoxes(eventInfo))
+	{
+		output << "\t\tstatic std::atomic<bool> " << eventInfo.sourceName << "BoxesInUse;\n";
+
+		for (auto& paramInfo : eventInfo.paramInfos)
+		{
+			if (isCachedEventBoxParam(paramInfo))
+				output << "\t\tstatic UINT32 " << eventInfo.sourceName << paramInfo.name << "BoxHandle;\n";
+		}
+	}
 
 	return output.str();
 }
@@ -1927,7 +2770,7 @@ std::string generateCppEventThunk(const MethodInfo& eventInfo, bool isModule)
 std::string generateClassNativeToScriptObjectLine(int flags, const std::string& typeName, const std::string& outputName, 
 	const std::string& scriptType, const std::string& argName, bool asRef = false, const std::string& indent = "\t\t")
 {
-	std::stringstream output;
+	CodeWriter output(256);
 
 	auto generateCreateLine = [&output, &outputName, asRef](const std::string& scriptType, const std::string& argName, const std::string& indent)
 	{
@@ -1939,8 +2782,7 @@ std::string generateClassNativeToScriptObjectLine(int flags, const std::string&
 
 	if(isBaseParam(flags))
 	{
-		std::vector<std::string> derivedClasses;
-		getDerivedClasses(typeName, derivedClasses);
+		ArrayRef<std::string> derivedClasses = getDerivedClasses(typeName);
 
 		if(!derivedClasses.empty())
 		{
@@ -1978,7 +2820,7 @@ std::string generateClassNativeToScriptObjectLine(int flags, const std::string&
 std::string generateNativeToScriptObjectLine(ParsedType type, int flags, const std::string& scriptName,
 	const std::string& argName, const std::string& indent = "\t\t")
 {
-	std::stringstream output;
+	CodeWriter output(256);
 
 	if (type == ParsedType::Resource)
 	{
@@ -2014,8 +2856,23 @@ std::string generateNativeToScriptObjectLine(ParsedType type, int flags, const s
 	return output.str();
 }
 
+/**
+ * Generates a statement assigning the value returned by a native call to its intermediate variable. Class types returned
+ * by value, reference or pointer are copy constructed directly into a new shared pointer, so the copy requires only a
+ * single allocation and no default construction.
+ */
+std::string generateReturnValueAssignment(const std::string& assignment, const std::string& value, 
+	const VarTypeInfo& returnInfo, ParsedType returnType)
+{
+	if (isClassType(returnType) && !isArrayOrVector(returnInfo.flags) && willBeDereferenced(returnInfo.flags))
+		return assignment + "bs_shared_ptr_new<" + returnInfo.typeName + ">(" + value + ")";
+
+	return assignment + value;
+}
+
 std::string generateMethodBodyBlockForParam(const std::string& name, const VarTypeInfo& varTypeInfo,
-	bool isLast, bool returnValue, std::stringstream& preCallActions, std::stringstream& postCallActions)
+	bool isLast, bool returnValue, CodeWriter& preCallActions, CodeWriter& postCallActions, 
+	bool fillBuffer = false)
 {
 	UserTypeInfo paramTypeInfo = getTypeInfo(varTypeInfo.typeName, varTypeInfo.flags);
 
@@ -2080,10 +2937,10 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 				else // Resource
 				{
 					postCallActions << generateNativeToScriptObjectLine(paramTypeInfo.type, varTypeInfo.flags, "scriptObj", "nativeObj", "\t\t\t");
-					postCallActions << "\t\t\tif(scriptObj != nullptr)" << std::endl;
-					postCallActions << "\t\t\t\tmonoObj = scriptObj->getManagedInstance();" << std::endl;
-					postCallActions << "\t\t\telse" << std::endl;
-					postCallActions << "\t\t\t\tmonoObj = nullptr;" << std::endl;
+					postCallActions << "\t\t\tif(scriptObj != nullptr)\n";
+					postCallActions << "\t\t\t\tmonoObj = scriptObj->getManagedInstance();\n";
+					postCallActions << "\t\t\telse\n";
+					postCallActions << "\t\t\t\tmonoObj = nullptr;\n";
 				}
 
 			}
@@ -2099,9 +2956,9 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 				postCallActions << ";\n";
 
 				postCallActions << "\t\t\tScriptArray " << arrayName;
-				postCallActions << " = " << "ScriptArray::create<" << scriptType << ">(arraySize);" << std::endl;
-				postCallActions << "\t\t\tfor(int i = 0; i < arraySize; i++)" << std::endl;
-				postCallActions << "\t\t\t{" << std::endl;
+				postCallActions << " = " << "ScriptArray::create<" << scriptType << ">(arraySize);\n";
+				postCallActions << "\t\t\tfor(int i = 0; i < arraySize; i++)\n";
+				postCallActions << "\t\t\t{\n";
 
 				switch (paramTypeInfo.type)
 				{
@@ -2116,19 +2973,14 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 					postCallActions << "\t\t\t\t" << elemPtrType << " " << elemPtrName;
 					if (willBeDereferenced(varTypeInfo.flags))
 					{
-						postCallActions << " = bs_shared_ptr_new<" << varTypeInfo.typeName << ">();\n";
-
 						if (isSrcPointer(varTypeInfo.flags))
 						{
+							postCallActions << " = bs_shared_ptr_new<" << varTypeInfo.typeName << ">();\n";
 							postCallActions << "\t\t\t\tif(nativeObj[i])\n";
-							postCallActions << "\t\t\t\t\t*" << elemPtrName << " = *";
+							postCallActions << "\t\t\t\t\t*" << elemPtrName << " = *nativeObj[i];\n";
 						}
 						else
-						{
-							postCallActions << "\t\t\t\t*" << elemPtrName << " = ";
-						}
-
-						postCallActions << "nativeObj[i];\n";
+							postCallActions << " = bs_shared_ptr_new<" << varTypeInfo.typeName << ">(nativeObj[i]);\n";
 					}
 					else
 						postCallActions << " = nativeObj[i];\n";
@@ -2137,7 +2989,7 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 					postCallActions << generateClassNativeToScriptObjectLine(varTypeInfo.flags, varTypeInfo.typeName, elemName,
 						scriptType, elemPtrName, false, "\t\t\t\t");
 
-					postCallActions << "\t\t\t\t" << arrayName << ".set(i, " << elemName << ");" << std::endl;
+					postCallActions << "\t\t\t\t" << arrayName << ".set(i, " << elemName << ");\n";
 					break;
 				}
 				case ParsedType::Resource:
@@ -2145,10 +2997,10 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 					std::string scriptName = "scriptObj";
 
 					postCallActions << generateNativeToScriptObjectLine(paramTypeInfo.type, varTypeInfo.flags, scriptName, "nativeObj[i]", "\t\t\t\t");
-					postCallActions << "\t\t\t\tif(" << scriptName << " != nullptr)" << std::endl;
-					postCallActions << "\t\t\t\t\t" << arrayName << ".set(i, " << scriptName << "->getManagedInstance());" << std::endl;
-					postCallActions << "\t\t\t\telse" << std::endl;
-					postCallActions << "\t\t\t\t\t" << arrayName << ".set(i, nullptr);" << std::endl;
+					postCallActions << "\t\t\t\tif(" << scriptName << " != nullptr)\n";
+					postCallActions << "\t\t\t\t\t" << arrayName << ".set(i, " << scriptName << "->getManagedInstance());\n";
+					postCallActions << "\t\t\t\telse\n";
+					postCallActions << "\t\t\t\t\t" << arrayName << ".set(i, nullptr);\n";
 				}
 				break;
 				default:
@@ -2156,8 +3008,8 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 					break;
 				}
 
-				postCallActions << "\t\t\t}" << std::endl;
-				postCallActions << "\t\t\tmonoObj = " << arrayName << ".getInternal();" << std::endl;
+				postCallActions << "\t\t\t}\n";
+				postCallActions << "\t\t\tmonoObj = " << arrayName << ".getInternal();\n";
 			}
 
 			postCallActions << "\t\t\treturn monoObj;\n";
@@ -2189,9 +3041,9 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 				argName = "tmp" + name;
 
 				if(isFlagsEnum(varTypeInfo.flags))
-					preCallActions << "\t\tFlags<" << varTypeInfo.typeName << "> " << argName << ";" << std::endl;
+					preCallActions << "\t\tFlags<" << varTypeInfo.typeName << "> " << argName << ";\n";
 				else
-					preCallActions << "\t\t" << varTypeInfo.typeName << " " << argName << ";" << std::endl;
+					preCallActions << "\t\t" << varTypeInfo.typeName << " " << argName << ";\n";
 
 				if (paramTypeInfo.type == ParsedType::Struct)
 				{
@@ -2207,19 +3059,19 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 						postCallActions << scriptType << "::getMetaData()->scriptClass->_getInternalClass());\n";
 					}
 					else
-						postCallActions << "\t\t*" << name << " = " << argName << ";" << std::endl;
+						postCallActions << "\t\t*" << name << " = " << argName << ";\n";
 				}
 				else if(isFlagsEnum(varTypeInfo.flags))
-					postCallActions << "\t\t" << name << " = (" << varTypeInfo.typeName << ")(uint32_t)" << argName << ";" << std::endl;
+					postCallActions << "\t\t" << name << " = (" << varTypeInfo.typeName << ")(uint32_t)" << argName << ";\n";
 				else
-					postCallActions << "\t\t" << name << " = " << argName << ";" << std::endl;
+					postCallActions << "\t\t" << name << " = " << argName << ";\n";
 			}
 			else if (isOutput(varTypeInfo.flags))
 			{
 				if(paramTypeInfo.type == ParsedType::Struct && isComplexStruct(varTypeInfo.flags))
 				{
 					argName = "tmp" + name;
-					preCallActions << "\t\t" << varTypeInfo.typeName << " " << argName << ";" << std::endl;
+					preCallActions << "\t\t" << varTypeInfo.typeName << " " << argName << ";\n";
 
 					std::string scriptType = getScriptInteropType(varTypeInfo.typeName);
 
@@ -2233,9 +3085,9 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 				else if (isFlagsEnum(varTypeInfo.flags))
 				{
 					argName = "tmp" + name;
-					preCallActions << "\t\tFlags<" << varTypeInfo.typeName << "> " << argName << ";" << std::endl;
+					preCallActions << "\t\tFlags<" << varTypeInfo.typeName << "> " << argName << ";\n";
 
-					postCallActions << "\t\t*" << name << " = (" << varTypeInfo.typeName << ")(uint32_t)" << argName << ";" << std::endl;
+					postCallActions << "\t\t*" << name << " = (" << varTypeInfo.typeName << ")(uint32_t)" << argName << ";\n";
 				}
 				else
 					argName = name;
@@ -2245,10 +3097,10 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 				if(paramTypeInfo.type == ParsedType::Struct && isComplexStruct(varTypeInfo.flags))
 				{
 					argName = "tmp" + name;
-					preCallActions << "\t\t" << varTypeInfo.typeName << " " << argName << ";" << std::endl;
+					preCallActions << "\t\t" << varTypeInfo.typeName << " " << argName << ";\n";
 
 					std::string scriptType = getScriptInteropType(varTypeInfo.typeName);
-					preCallActions << "\t\t" << argName << " = " << scriptType << "::fromInterop(*" << name << ");" << std::endl;
+					preCallActions << "\t\t" << argName << " = " << scriptType << "::fromInterop(*" << name << ");\n";
 				}
 				else
 					argName = name;
@@ -2258,40 +3110,40 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 		case ParsedType::String:
 		{
 			argName = "tmp" + name;
-			preCallActions << "\t\tString " << argName << ";" << std::endl;
+			preCallActions << "\t\tString " << argName << ";\n";
 
 			if (returnValue)
-				postCallActions << "\t\t" << name << " = MonoUtil::stringToMono(" << argName << ");" << std::endl;
+				postCallActions << "\t\t" << name << " = MonoUtil::stringToMono(" << argName << ");\n";
 			else if (isOutput(varTypeInfo.flags))
-				postCallActions << "\t\tMonoUtil::referenceCopy(" << name << ",  (MonoObject*)MonoUtil::stringToMono(" << argName << "));" << std::endl;
+				postCallActions << "\t\tMonoUtil::referenceCopy(" << name << ",  (MonoObject*)MonoUtil::stringToMono(" << argName << "));\n";
 			else
-				preCallActions << "\t\t" << argName << " = MonoUtil::monoToString(" << name << ");" << std::endl;
+				preCallActions << "\t\t" << argName << " = MonoUtil::monoToString(" << name << ");\n";
 		}
 		break;
 		case ParsedType::Path:
 		{
 			argName = "tmp" + name;
-			preCallActions << "\t\tPath " << argName << ";" << std::endl;
+			preCallActions << "\t\tPath " << argName << ";\n";
 
 			if (returnValue)
-				postCallActions << "\t\t" << name << " = MonoUtil::stringToMono(" << argName << ".toString());" << std::endl;
+				postCallActions << "\t\t" << name << " = MonoUtil::stringToMono(" << argName << ".toString());\n";
 			else if (isOutput(varTypeInfo.flags))
-				postCallActions << "\t\tMonoUtil::referenceCopy(" << name << ",  (MonoObject*)MonoUtil::stringToMono(" << argName << ".toString()));" << std::endl;
+				postCallActions << "\t\tMonoUtil::referenceCopy(" << name << ",  (MonoObject*)MonoUtil::stringToMono(" << argName << ".toString()));\n";
 			else
-				preCallActions << "\t\t" << argName << " = MonoUtil::monoToString(" << name << ");" << std::endl;
+				preCallActions << "\t\t" << argName << " = MonoUtil::monoToString(" << name << ");\n";
 		}
 		break;
 		case ParsedType::WString:
 		{
 			argName = "tmp" + name;
-			preCallActions << "\t\tWString " << argName << ";" << std::endl;
+			preCallActions << "\t\tWString " << argName << ";\n";
 
 			if (returnValue)
-				postCallActions << "\t\t" << name << " = MonoUtil::wstringToMono(" << argName << ");" << std::endl;
+				postCallActions << "\t\t" << name << " = MonoUtil::wstringToMono(" << argName << ");\n";
 			else if (isOutput(varTypeInfo.flags))
-				postCallActions << "\t\tMonoUtil::referenceCopy(" << name << ", (MonoObject*)MonoUtil::wstringToMono(" << argName << "));" << std::endl;
+				postCallActions << "\t\tMonoUtil::referenceCopy(" << name << ", (MonoObject*)MonoUtil::wstringToMono(" << argName << "));\n";
 			else
-				preCallActions << "\t\t" << argName << " = MonoUtil::monoToWString(" << name << ");" << std::endl;
+				preCallActions << "\t\t" << argName << " = MonoUtil::monoToWString(" << name << ");\n";
 		}
 		break;
 		case ParsedType::MonoObject:
@@ -2300,13 +3152,13 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 			
 			if (returnValue)
 			{
-				preCallActions << "\t\tMonoObject* " << argName << ";" << std::endl;
-				postCallActions << "\t\t" << name << " = " << argName << ";" << std::endl;
+				preCallActions << "\t\tMonoObject* " << argName << ";\n";
+				postCallActions << "\t\t" << name << " = " << argName << ";\n";
 			}
 			else if (isOutput(varTypeInfo.flags))
 			{
-				preCallActions << "\t\tMonoObject* " << argName << ";" << std::endl;
-				postCallActions << "\t\tMonoUtil::referenceCopy(" << name << ", " << argName << ");" << std::endl;
+				preCallActions << "\t\tMonoObject* " << argName << ";\n";
+				postCallActions << "\t\tMonoUtil::referenceCopy(" << name << ", " << argName << ");\n";
 			}
 			else
 			{
@@ -2329,9 +3181,9 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 
 				preCallActions << generateManagedToScriptObjectLine("\t\t", scriptType, scriptName, name, 
 					paramTypeInfo.type, varTypeInfo.flags);
-				preCallActions << "\t\tif(" << scriptName << " != nullptr)" << std::endl;
+				preCallActions << "\t\tif(" << scriptName << " != nullptr)\n";
 				preCallActions << "\t\t\t" << argName << " = " << generateGetInternalLine(varTypeInfo.typeName, scriptName, 
-					paramTypeInfo.type, varTypeInfo.flags) << ";" << std::endl;
+					paramTypeInfo.type, varTypeInfo.flags) << ";\n";
 			}
 		}
 			break;
@@ -2342,8 +3194,9 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 			std::string tmpType = getCppVarType(varTypeInfo.typeName, paramTypeInfo.type);
 			std::string scriptType = getScriptInteropType(varTypeInfo.typeName);
 
+			// Return values are copy constructed into the shared pointer once the call returns
 			preCallActions << "\t\t" << tmpType << " " << argName;
-			if ((returnValue || isOutput(varTypeInfo.flags)) && willBeDereferenced(varTypeInfo.flags))
+			if (!returnValue && isOutput(varTypeInfo.flags) && willBeDereferenced(varTypeInfo.flags))
 				preCallActions << " = bs_shared_ptr_new<" << varTypeInfo.typeName << ">()";
 
 			preCallActions << ";\n";
@@ -2358,9 +3211,9 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 				
 				preCallActions << generateManagedToScriptObjectLine("\t\t", scriptType, scriptName, name, 
 					paramTypeInfo.type, varTypeInfo.flags);
-				preCallActions << "\t\tif(" << scriptName << " != nullptr)" << std::endl;
+				preCallActions << "\t\tif(" << scriptName << " != nullptr)\n";
 				preCallActions << "\t\t\t" << argName << " = " << generateGetInternalLine(varTypeInfo.typeName, scriptName, 
-					paramTypeInfo.type, varTypeInfo.flags) << ";" << std::endl;
+					paramTypeInfo.type, varTypeInfo.flags) << ";\n";
 			}
 		}
 			break;
@@ -2369,7 +3222,7 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 			argName = "tmp" + name;
 			std::string tmpType = getCppVarType(varTypeInfo.typeName, paramTypeInfo.type);
 
-			preCallActions << "\t\t" << tmpType << " " << argName << ";" << std::endl;
+			preCallActions << "\t\t" << tmpType << " " << argName << ";\n";
 
 			std::string scriptName = "script" + name;
 			std::string scriptType = getScriptInteropType(varTypeInfo.typeName, getPassAsResourceRef(varTypeInfo.flags));
@@ -2377,24 +3230,24 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 			if (returnValue)
 			{
 				postCallActions << generateNativeToScriptObjectLine(paramTypeInfo.type, varTypeInfo.flags, scriptName, argName);
-				postCallActions << "\t\tif(" << scriptName << " != nullptr)" << std::endl;
-				postCallActions << "\t\t\t" << name << " = " << scriptName << "->getManagedInstance();" << std::endl;
-				postCallActions << "\t\telse" << std::endl;
-				postCallActions << "\t\t\t" << name << " = nullptr;" << std::endl;
+				postCallActions << "\t\tif(" << scriptName << " != nullptr)\n";
+				postCallActions << "\t\t\t" << name << " = " << scriptName << "->getManagedInstance();\n";
+				postCallActions << "\t\telse\n";
+				postCallActions << "\t\t\t" << name << " = nullptr;\n";
 			}
 			else if (isOutput(varTypeInfo.flags))
 			{
 				postCallActions << generateNativeToScriptObjectLine(paramTypeInfo.type, varTypeInfo.flags, scriptName, argName);
-				postCallActions << "\t\tif(" << scriptName << " != nullptr)" << std::endl;
-				postCallActions << "\t\t\tMonoUtil::referenceCopy(" << name << ", " << scriptName << "->getManagedInstance());" << std::endl;
-				postCallActions << "\t\telse" << std::endl;
-				postCallActions << "\t\t\t*" << name << " = nullptr;" << std::endl;
+				postCallActions << "\t\tif(" << scriptName << " != nullptr)\n";
+				postCallActions << "\t\t\tMonoUtil::referenceCopy(" << name << ", " << scriptName << "->getManagedInstance());\n";
+				postCallActions << "\t\telse\n";
+				postCallActions << "\t\t\t*" << name << " = nullptr;\n";
 			}
 			else
 			{
 				preCallActions << generateManagedToScriptObjectLine("\t\t", scriptType, scriptName, name, paramTypeInfo.type, varTypeInfo.flags);
-				preCallActions << "\t\tif(" << scriptName << " != nullptr)" << std::endl;
-				preCallActions << "\t\t\t" << argName << " = " << generateGetInternalLine(varTypeInfo.typeName, scriptName, paramTypeInfo.type, varTypeInfo.flags) << ";" << std::endl;
+				preCallActions << "\t\tif(" << scriptName << " != nullptr)\n";
+				preCallActions << "\t\t\t" << argName << " = " << generateGetInternalLine(varTypeInfo.typeName, scriptName, paramTypeInfo.type, varTypeInfo.flags) << ";\n";
 			}
 		}
 		break;
@@ -2445,13 +3298,13 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 			preCallActions << "\t\tif(" << name << " != nullptr)\n";
 			preCallActions << "\t\t{\n";
 
-			preCallActions << "\t\t\tScriptArray " << arrayName << "(" << name << ");" << std::endl;
+			preCallActions << "\t\t\tScriptArray " << arrayName << "(" << name << ");\n";
 
 			if(isVector(varTypeInfo.flags) || isSmallVector(varTypeInfo.flags))
-				preCallActions << "\t\t\t" << argName << ".resize(" << arrayName << ".size());" << std::endl;
+				preCallActions << "\t\t\t" << argName << ".resize(" << arrayName << ".size());\n";
 
-			preCallActions << "\t\t\tfor(int i = 0; i < (int)" << arrayName << ".size(); i++)" << std::endl;
-			preCallActions << "\t\t\t{" << std::endl;
+			preCallActions << "\t\t\tfor(int i = 0; i < (int)" << arrayName << ".size(); i++)\n";
+			preCallActions << "\t\t\t{\n";
 
 			switch (paramTypeInfo.type)
 			{
@@ -2459,7 +3312,7 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 			case ParsedType::String:
 			case ParsedType::WString:
 			case ParsedType::Path:
-				preCallActions << "\t\t\t\t" << argName << "[i] = " << arrayName << ".get<" << entryType << ">(i);" << std::endl;
+				preCallActions << "\t\t\t\t" << argName << "[i] = " << arrayName << ".get<" << entryType << ">(i);\n";
 				break;
 			case ParsedType::MonoObject:
 				outs() << "Error: MonoObject type not supported as input. Ignoring. \n";
@@ -2469,7 +3322,7 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 				std::string enumType;
 				mapBuiltinTypeToCppType(paramTypeInfo.underlyingType, enumType);
 
-				preCallActions << "\t\t\t\t" << argName << "[i] = (" << entryType << ")" << arrayName << ".get<" << enumType << ">(i);" << std::endl;
+				preCallActions << "\t\t\t\t" << argName << "[i] = (" << entryType << ")" << arrayName << ".get<" << enumType << ">(i);\n";
 				break;
 			}
 			case ParsedType::Struct:
@@ -2522,10 +3375,10 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 			break;
 			}
 
-			preCallActions << "\t\t\t}" << std::endl;
+			preCallActions << "\t\t\t}\n";
 
 			if (!isLast)
-				preCallActions << std::endl;
+				preCallActions << "\n";
 
 			preCallActions << "\t\t}\n";
 		}
@@ -2540,10 +3393,30 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 				postCallActions << varTypeInfo.arraySize;
 			postCallActions << ";\n";
 
-			postCallActions << "\t\tScriptArray " << arrayName;
-			postCallActions << " = " << "ScriptArray::create<" << entryType << ">(arraySize" << name << ");" << std::endl;
-			postCallActions << "\t\tfor(int i = 0; i < arraySize" << name << "; i++)" << std::endl;
-			postCallActions << "\t\t{" << std::endl;
+			if (fillBuffer)
+			{
+				// Write into the provided array, and only allocate a new one if it cannot fit the results
+				std::string bufferName = "buffer" + name;
+
+				postCallActions << "\t\tMonoArray* " << bufferName << " = *" << name << ";\n";
+				postCallActions << "\t\tif(" << bufferName << " == nullptr || (int)ScriptArray(" << bufferName << 
+					").size() < arraySize" << name << ")\n";
+				postCallActions << "\t\t{\n";
+				postCallActions << "\t\t\t" << bufferName << " = ScriptArray::create<" << entryType << ">(arraySize" << 
+					name << ").getInternal();\n";
+				postCallActions << "\t\t\tMonoUtil::referenceCopy(" << name << ", (MonoObject*)" << bufferName << ");\n";
+				postCallActions << "\t\t}\n";
+				postCallActions << "\n";
+				postCallActions << "\t\tScriptArray " << arrayName << "(" << bufferName << ");\n";
+			}
+			else
+			{
+				postCallActions << "\t\tScriptArray " << arrayName;
+				postCallActions << " = " << "ScriptArray::create<" << entryType << ">(arraySize" << name << ");\n";
+			}
+
+			postCallActions << "\t\tfor(int i = 0; i < arraySize" << name << "; i++)\n";
+			postCallActions << "\t\t{\n";
 
 			switch (paramTypeInfo.type)
 			{
@@ -2551,7 +3424,7 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 			case ParsedType::String:
 			case ParsedType::WString:
 			case ParsedType::Path:
-				postCallActions << "\t\t\t" << arrayName << ".set(i, " << argName << "[i]);" << std::endl;
+				postCallActions << "\t\t\t" << arrayName << ".set(i, " << argName << "[i]);\n";
 				break;
 			case ParsedType::Enum:
 			{
@@ -2559,9 +3432,9 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 				mapBuiltinTypeToCppType(paramTypeInfo.underlyingType, enumType);
 
 				if(isFlagsEnum(varTypeInfo.flags))
-					postCallActions << "\t\t\t" << arrayName << ".set(i, (" << enumType << ")(uint32_t)" << argName << "[i]);" << std::endl;
+					postCallActions << "\t\t\t" << arrayName << ".set(i, (" << enumType << ")(uint32_t)" << argName << "[i]);\n";
 				else
-					postCallActions << "\t\t\t" << arrayName << ".set(i, (" << enumType << ")" << argName << "[i]);" << std::endl;
+					postCallActions << "\t\t\t" << arrayName << ".set(i, (" << enumType << ")" << argName << "[i]);\n";
 				break;
 			}
 			case ParsedType::Struct:
@@ -2579,7 +3452,7 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 
 				break;
 			case ParsedType::MonoObject:
-				postCallActions << "\t\t\t" << arrayName << ".set(i, " << argName << "[i]);" << std::endl;
+				postCallActions << "\t\t\t" << arrayName << ".set(i, " << argName << "[i]);\n";
 				break;
 			case ParsedType::Class:
 			case ParsedType::ReflectableClass:
@@ -2592,19 +3465,14 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 				postCallActions << "\t\t\t" << elemPtrType << " " << elemPtrName;
 				if(willBeDereferenced(varTypeInfo.flags))
 				{
-					postCallActions << " = bs_shared_ptr_new<" << varTypeInfo.typeName << ">();\n";
-
 					if (isSrcPointer(varTypeInfo.flags))
 					{
+						postCallActions << " = bs_shared_ptr_new<" << varTypeInfo.typeName << ">();\n";
 						postCallActions << "\t\t\tif(" << argName << "[i])\n";
-						postCallActions << "\t\t\t\t*" << elemPtrName << " = *";
+						postCallActions << "\t\t\t\t*" << elemPtrName << " = *" << argName << "[i];\n";
 					}
 					else
-					{
-						postCallActions << "\t\t\t*" << elemPtrName << " = ";
-					}
-
-					postCallActions << argName << "[i];\n";
+						postCallActions << " = bs_shared_ptr_new<" << varTypeInfo.typeName << ">(" << argName << "[i]);\n";
 				}
 				else
 					postCallActions << " = " << argName << "[i];\n";
@@ -2613,7 +3481,7 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 				postCallActions << generateClassNativeToScriptObjectLine(varTypeInfo.flags, varTypeInfo.typeName, elemName, 
 					entryType, elemPtrName, false, "\t\t\t");
 
-				postCallActions << "\t\t\t" << arrayName << ".set(i, " << elemName << ");" << std::endl;
+				postCallActions << "\t\t\t" << arrayName << ".set(i, " << elemName << ");\n";
 				break;
 			}
 			case ParsedType::GUIElement:
@@ -2624,27 +3492,31 @@ std::string generateMethodBodyBlockForParam(const std::string& name, const VarTy
 				std::string scriptName = "script" + name;
 
 				postCallActions << generateNativeToScriptObjectLine(paramTypeInfo.type, varTypeInfo.flags, scriptName, argName + "[i]", "\t\t\t");
-				postCallActions << "\t\t\tif(" << scriptName << " != nullptr)" << std::endl;
-				postCallActions << "\t\t\t\t" << arrayName << ".set(i, " << scriptName << "->getManagedInstance());" << std::endl;
-				postCallActions << "\t\t\telse" << std::endl;
-				postCallActions << "\t\t\t\t" << arrayName << ".set(i, nullptr);" << std::endl;
+				postCallActions << "\t\t\tif(" << scriptName << " != nullptr)\n";
+				postCallActions << "\t\t\t\t" << arrayName << ".set(i, " << scriptName << "->getManagedInstance());\n";
+				postCallActions << "\t\t\telse\n";
+				postCallActions << "\t\t\t\t" << arrayName << ".set(i, nullptr);\n";
 			}
 			break;
 			}
 
-			postCallActions << "\t\t}" << std::endl;
+			postCallActions << "\t\t}\n";
 
-			if (returnValue)
-				postCallActions << "\t\t" << name << " = " << arrayName << ".getInternal();" << std::endl;
-			else
-				postCallActions << "\t\tMonoUtil::referenceCopy(" << name << ", (MonoObject*)" << arrayName << ".getInternal());" << std::endl;
+			// When filling a buffer the array is already referenced by the output
+			if (!fillBuffer)
+			{
+				if (returnValue)
+					postCallActions << "\t\t" << name << " = " << arrayName << ".getInternal();\n";
+				else
+					postCallActions << "\t\tMonoUtil::referenceCopy(" << name << ", (MonoObject*)" << arrayName << ".getInternal());\n";
+			}
 		}
 
 		return argName;
 	}
 }
 
-std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo& varTypeInfo, bool toInterop, std::stringstream& preActions)
+std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo& varTypeInfo, bool toInterop, CodeWriter& preActions)
 {
 	UserTypeInfo paramTypeInfo = getTypeInfo(varTypeInfo.typeName, varTypeInfo.flags);
 
@@ -2673,13 +3545,13 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 				arg = "tmp" + name;
 				if(toInterop)
 				{
-					preActions << "\t\t" << interopType << " " << arg << ";" << std::endl;
-					preActions << "\t\t" << arg << " = " << scriptType << "::toInterop(value." << name << ");" << std::endl;
+					preActions << "\t\t" << interopType << " " << arg << ";\n";
+					preActions << "\t\t" << arg << " = " << scriptType << "::toInterop(value." << name << ");\n";
 				}
 				else
 				{
-					preActions << "\t\t" << varTypeInfo.typeName << " " << arg << ";" << std::endl;
-					preActions << "\t\t" << arg << " = " << scriptType << "::fromInterop(value." << name << ");" << std::endl;
+					preActions << "\t\t" << varTypeInfo.typeName << " " << arg << ";\n";
+					preActions << "\t\t" << arg << " = " << scriptType << "::fromInterop(value." << name << ");\n";
 				}
 			}
 			else
@@ -2691,13 +3563,13 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 
 			if(toInterop)
 			{
-				preActions << "\t\tMonoString* " << arg << ";" << std::endl;
-				preActions << "\t\t" << arg << " = MonoUtil::stringToMono(value." << name << ");" << std::endl;
+				preActions << "\t\tMonoString* " << arg << ";\n";
+				preActions << "\t\t" << arg << " = MonoUtil::stringToMono(value." << name << ");\n";
 			}
 			else
 			{
-				preActions << "\t\tString " << arg << ";" << std::endl;
-				preActions << "\t\t" << arg << " = MonoUtil::monoToString(value." << name << ");" << std::endl;
+				preActions << "\t\tString " << arg << ";\n";
+				preActions << "\t\t" << arg << " = MonoUtil::monoToString(value." << name << ");\n";
 			}
 		}
 		break;
@@ -2707,13 +3579,13 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 
 			if(toInterop)
 			{
-				preActions << "\t\tMonoString* " << arg << ";" << std::endl;
-				preActions << "\t\t" << arg << " = MonoUtil::wstringToMono(value." << name << ");" << std::endl;
+				preActions << "\t\tMonoString* " << arg << ";\n";
+				preActions << "\t\t" << arg << " = MonoUtil::wstringToMono(value." << name << ");\n";
 			}
 			else
 			{
-				preActions << "\t\tWString " << arg << ";" << std::endl;
-				preActions << "\t\t" << arg << " = MonoUtil::monoToWString(value." << name << ");" << std::endl;
+				preActions << "\t\tWString " << arg << ";\n";
+				preActions << "\t\t" << arg << " = MonoUtil::monoToWString(value." << name << ");\n";
 			}
 		}
 		break;
@@ -2723,13 +3595,13 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 
 			if(toInterop)
 			{
-				preActions << "\t\tMonoString* " << arg << ";" << std::endl;
-				preActions << "\t\t" << arg << " = MonoUtil::stringToMono(value." << name << ".toString());" << std::endl;
+				preActions << "\t\tMonoString* " << arg << ";\n";
+				preActions << "\t\t" << arg << " = MonoUtil::stringToMono(value." << name << ".toString());\n";
 			}
 			else
 			{
-				preActions << "\t\tPath " << arg << ";" << std::endl;
-				preActions << "\t\t" << arg << " = MonoUtil::monoToString(value." << name << ");" << std::endl;
+				preActions << "\t\tPath " << arg << ";\n";
+				preActions << "\t\t" << arg << " = MonoUtil::monoToString(value." << name << ");\n";
 			}
 		}
 		break;
@@ -2737,8 +3609,8 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 		{
 			arg = "tmp" + name;
 
-			preActions << "\t\tMonoObject* " << arg << ";" << std::endl;
-			preActions << "\t\t" << arg << " = " << name << ";" << std::endl;
+			preActions << "\t\tMonoObject* " << arg << ";\n";
+			preActions << "\t\t" << arg << " = " << name << ";\n";
 		}
 		break;
 		case ParsedType::GUIElement:
@@ -2751,14 +3623,14 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 				if(isSrcPointer(varTypeInfo.flags))
 				{
 					std::string tmpType = getCppVarType(varTypeInfo.typeName, paramTypeInfo.type);
-					preActions << "\t\t" << tmpType << " " << arg << ";" << std::endl;
+					preActions << "\t\t" << tmpType << " " << arg << ";\n";
 
 					std::string scriptName = "script" + name;
 					preActions << generateManagedToScriptObjectLine("\t\t", scriptType, scriptName, "value." + name, 
 						paramTypeInfo.type, varTypeInfo.flags);
-					preActions << "\t\tif(" << scriptName << " != nullptr)" << std::endl;
+					preActions << "\t\tif(" << scriptName << " != nullptr)\n";
 					preActions << "\t\t\t" << arg << " = " << generateGetInternalLine(varTypeInfo.typeName, scriptName,
-						paramTypeInfo.type, varTypeInfo.flags) << ";" << std::endl;
+						paramTypeInfo.type, varTypeInfo.flags) << ";\n";
 				}
 				else
 					outs() << "Error: Invalid struct member type for \"" << name << "\"\n";
@@ -2800,17 +3672,17 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 			else
 			{
 				std::string tmpType = getCppVarType(varTypeInfo.typeName, paramTypeInfo.type);
-				preActions << "\t\t" << tmpType << " " << arg << ";" << std::endl;
+				preActions << "\t\t" << tmpType << " " << arg << ";\n";
 
 				std::string scriptName = "script" + name;
 				preActions << generateManagedToScriptObjectLine("\t\t", scriptType, scriptName, "value." + name, paramTypeInfo.type, varTypeInfo.flags);
-				preActions << "\t\tif(" << scriptName << " != nullptr)" << std::endl;
-				preActions << "\t\t\t" << arg << " = " << scriptName << "->getInternal();" << std::endl;
+				preActions << "\t\tif(" << scriptName << " != nullptr)\n";
+				preActions << "\t\t\t" << arg << " = " << scriptName << "->getInternal();\n";
 
 				// Cast to the source type from SPtr
 				if (isSrcValue(varTypeInfo.flags))
 				{
-					preActions << "\t\tif(" << arg << " != nullptr)" << std::endl;
+					preActions << "\t\tif(" << arg << " != nullptr)\n";
 					arg = "*" + arg;
 				}
 				else if (isSrcPointer(varTypeInfo.flags))
@@ -2839,18 +3711,18 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 
 				preActions << "\t\tMonoObject* " << arg << ";\n";
 				preActions << "\t\tif(" << scriptName << " != nullptr)\n";
-				preActions << "\t\t\t" << arg << " = " << scriptName << "->getManagedInstance();" << std::endl;
+				preActions << "\t\t\t" << arg << " = " << scriptName << "->getManagedInstance();\n";
 				preActions << "\t\telse\n";
 				preActions << "\t\t\t" << arg << " = nullptr;\n";
 			}
 			else
 			{
 				std::string tmpType = getCppVarType(varTypeInfo.typeName, paramTypeInfo.type);
-				preActions << "\t\t" << tmpType << " " << arg << ";" << std::endl;
+				preActions << "\t\t" << tmpType << " " << arg << ";\n";
 				
 				preActions << generateManagedToScriptObjectLine("\t\t", scriptType, scriptName, "value." + name, paramTypeInfo.type, varTypeInfo.flags);
 				preActions << "\t\tif(" << scriptName << " != nullptr)\n";
-				preActions << "\t\t\t" << arg << " = " << generateGetInternalLine(varTypeInfo.typeName, scriptName, paramTypeInfo.type, varTypeInfo.flags) << ";" << std::endl;
+				preActions << "\t\t\t" << arg << " = " << generateGetInternalLine(varTypeInfo.typeName, scriptName, paramTypeInfo.type, varTypeInfo.flags) << ";\n";
 			}
 
 			if(!isSrcGHandle(varTypeInfo.flags) && !isSrcRHandle(varTypeInfo.flags))
@@ -2897,17 +3769,17 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 			preActions << "\t\t" << argType << " " << argName;
 			if (isArray(varTypeInfo.flags))
 				preActions << "[" << varTypeInfo.arraySize << "]";
-			preActions << ";" << std::endl;
+			preActions << ";\n";
 
 			preActions << "\t\tif(value." << name << " != nullptr)\n";
 			preActions << "\t\t{\n";
-			preActions << "\t\t\tScriptArray " << arrayName << "(value." << name << ");" << std::endl;
+			preActions << "\t\t\tScriptArray " << arrayName << "(value." << name << ");\n";
 
 			if(isVector(varTypeInfo.flags) || isSmallVector(varTypeInfo.flags))
-				preActions << "\t\t\t" << argName << ".resize(" << arrayName << ".size());" << std::endl;
+				preActions << "\t\t\t" << argName << ".resize(" << arrayName << ".size());\n";
 
-			preActions << "\t\t\tfor(int i = 0; i < (int)" << arrayName << ".size(); i++)" << std::endl;
-			preActions << "\t\t\t{" << std::endl;
+			preActions << "\t\t\tfor(int i = 0; i < (int)" << arrayName << ".size(); i++)\n";
+			preActions << "\t\t\t{\n";
 
 			switch (paramTypeInfo.type)
 			{
@@ -2915,7 +3787,7 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 			case ParsedType::String:
 			case ParsedType::WString:
 			case ParsedType::Path:
-				preActions << "\t\t\t\t" << argName << "[i] = " << arrayName << ".get<" << entryType << ">(i);" << std::endl;
+				preActions << "\t\t\t\t" << argName << "[i] = " << arrayName << ".get<" << entryType << ">(i);\n";
 				break;
 			case ParsedType::MonoObject:
 				outs() << "Error: MonoObject type not supported as input. Ignoring. \n";
@@ -2925,7 +3797,7 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 				std::string enumType;
 				mapBuiltinTypeToCppType(paramTypeInfo.underlyingType, enumType);
 
-				preActions << "\t\t\t\t" << argName << "[i] = (" << entryType << ")" << arrayName << ".get<" << enumType << ">(i);" << std::endl;
+				preActions << "\t\t\t\t" << argName << "[i] = (" << entryType << ")" << arrayName << ".get<" << enumType << ">(i);\n";
 				break;
 			}
 			case ParsedType::Struct:
@@ -2976,7 +3848,7 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 			break;
 			}
 
-			preActions << "\t\t\t}" << std::endl;
+			preActions << "\t\t\t}\n";
 			preActions << "\t\t}\n";
 		}
 		else
@@ -2988,13 +3860,13 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 				preActions << varTypeInfo.arraySize;
 			preActions << ";\n";
 
-			preActions << "\t\tMonoArray* " << argName << ";" << std::endl;
+			preActions << "\t\tMonoArray* " << argName << ";\n";
 
 			std::string arrayName = "array" + name;
 			preActions << "\t\tScriptArray " << arrayName;
-			preActions << " = " << "ScriptArray::create<" << entryType << ">(arraySize" << name << ");" << std::endl;
-			preActions << "\t\tfor(int i = 0; i < arraySize" << name << "; i++)" << std::endl;
-			preActions << "\t\t{" << std::endl;
+			preActions << " = " << "ScriptArray::create<" << entryType << ">(arraySize" << name << ");\n";
+			preActions << "\t\tfor(int i = 0; i < arraySize" << name << "; i++)\n";
+			preActions << "\t\t{\n";
 
 			switch (paramTypeInfo.type)
 			{
@@ -3002,14 +3874,14 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 			case ParsedType::String:
 			case ParsedType::WString:
 			case ParsedType::Path:
-				preActions << "\t\t\t" << arrayName << ".set(i, value." << name << "[i]);" << std::endl;
+				preActions << "\t\t\t" << arrayName << ".set(i, value." << name << "[i]);\n";
 				break;
 			case ParsedType::Enum:
 			{
 				std::string enumType;
 				mapBuiltinTypeToCppType(paramTypeInfo.underlyingType, enumType);
 
-				preActions << "\t\t\t" << arrayName << ".set(i, (" << enumType << ")value." << name << "[i]);" << std::endl;
+				preActions << "\t\t\t" << arrayName << ".set(i, (" << enumType << ")value." << name << "[i]);\n";
 				break;
 			}
 			case ParsedType::Struct:
@@ -3026,7 +3898,7 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 				preActions << ");\n";
 				break;
 			case ParsedType::MonoObject:
-				preActions << "\t\t\t" << arrayName << ".set(i, value." << name << "[i]);" << std::endl;
+				preActions << "\t\t\t" << arrayName << ".set(i, value." << name << "[i]);\n";
 				break;
 			case ParsedType::Class:
 			case ParsedType::ReflectableClass:
@@ -3039,19 +3911,14 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 				preActions << "\t\t\t" << elemPtrType << " " << elemPtrName;
 				if(willBeDereferenced(varTypeInfo.flags))
 				{
-					preActions << " = bs_shared_ptr_new<" << varTypeInfo.typeName << ">();\n";
-
 					if (isSrcPointer(varTypeInfo.flags))
 					{
+						preActions << " = bs_shared_ptr_new<" << varTypeInfo.typeName << ">();\n";
 						preActions << "\t\t\tif(value." << name << "[i])\n";
-						preActions << "\t\t\t\t*" << elemPtrName << " = *";
+						preActions << "\t\t\t\t*" << elemPtrName << " = *value." << name << "[i];\n";
 					}
 					else
-					{
-						preActions << "\t\t\t*" << elemPtrName << " = ";
-					}
-
-					preActions << "value." << name << "[i];\n";
+						preActions << " = bs_shared_ptr_new<" << varTypeInfo.typeName << ">(value." << name << "[i]);\n";
 				}
 				else
 					preActions << " = value." << name << "[i];\n";
@@ -3060,7 +3927,7 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 				preActions << generateClassNativeToScriptObjectLine(varTypeInfo.flags, varTypeInfo.typeName, elemName, 
 					entryType, elemPtrName, false, "\t\t\t");
 
-				preActions << "\t\t\t" << arrayName << ".set(i, " << elemName << ");" << std::endl;
+				preActions << "\t\t\t" << arrayName << ".set(i, " << elemName << ");\n";
 			}
 			break;
 			case ParsedType::GUIElement:
@@ -3072,22 +3939,53 @@ std::string generateFieldConvertBlock(const std::string& name, const VarTypeInfo
 
 				preActions << generateNativeToScriptObjectLine(paramTypeInfo.type, varTypeInfo.flags, scriptName, "value." + name + "[i]", "\t\t\t");
 				preActions << "\t\t\t\tif(" << scriptName << " != nullptr)\n";
-				preActions << "\t\t\t\t" << arrayName << ".set(i, " << scriptName << "->getManagedInstance());" << std::endl;
+				preActions << "\t\t\t\t" << arrayName << ".set(i, " << scriptName << "->getManagedInstance());\n";
 				preActions << "\t\t\telse\n";
-				preActions << "\t\t\t\t" << arrayName << ".set(i, nullptr);" << std::endl;
+				preActions << "\t\t\t\t" << arrayName << ".set(i, nullptr);\n";
 			}
 			break;
 			}
 
-			preActions << "\t\t}" << std::endl;
-			preActions << "\t\t" << argName << " = " << arrayName << ".getInternal();" << std::endl;
+			preActions << "\t\t}\n";
+			preActions << "\t\t" << argName << " = " << arrayName << ".getInternal();\n";
 		}
 
 		return argName;
 	}
 }
 
-std::string generateEventCallbackBodyBlockForParam(const std::string& name, const VarTypeInfo& varTypeInfo, std::stringstream& preCallActions)
+/** 
+ * Generates code that retrieves a view over the memory of a managed array parameter, without copying it. Returns the 
+ * pointer and size arguments to pass to the native method in place of the vector.
+ */
+std::string generateSpanBlockForParam(const std::string& name, const VarTypeInfo& varTypeInfo, bool isLast, 
+	CodeWriter& preCallActions)
+{
+	UserTypeInfo paramTypeInfo = getTypeInfo(varTypeInfo.typeName, varTypeInfo.flags);
+	std::string entryType = getCppVarType(varTypeInfo.typeName, paramTypeInfo.type, varTypeInfo.flags, false);
+
+	std::string dataName = "spanData" + name;
+	std::string sizeName = "spanSize" + name;
+	std::string arrayName = "array" + name;
+
+	// Managed arrays are pinned for the duration of the internal call, so their memory can be referenced directly
+	preCallActions << "\t\tconst " << entryType << "* " << dataName << " = nullptr;\n";
+	preCallActions << "\t\tUINT32 " << sizeName << " = 0;\n";
+	preCallActions << "\t\tif(" << name << " != nullptr)\n";
+	preCallActions << "\t\t{\n";
+	preCallActions << "\t\t\tScriptArray " << arrayName << "(" << name << ");\n";
+	preCallActions << "\t\t\t" << sizeName << " = " << arrayName << ".size();\n";
+	preCallActions << "\t\t\t" << dataName << " = " << arrayName << ".getRawPtr<" << entryType << ">();\n";
+	preCallActions << "\t\t}\n";
+
+	if (!isLast)
+		preCallActions << "\n";
+
+	return dataName + ", " + sizeName;
+}
+
+std::string generateEventCallbackBodyBlockForParam(const std::string& name, const VarTypeInfo& varTypeInfo, 
+	const std::string& eventName, CodeWriter& preCallActions)
 {
 	UserTypeInfo paramTypeInfo = getTypeInfo(varTypeInfo.typeName, varTypeInfo.flags);
 
@@ -3110,8 +4008,8 @@ std::string generateEventCallbackBodyBlockForParam(const std::string& name, cons
 			if(isFlagsEnum(varTypeInfo.flags))
 			{
 				argName = "tmp" + name;
-				preCallActions << "\t\t" << varTypeInfo.typeName << argName << ";" << std::endl;
-				preCallActions << "\t\t" << argName << " = (" << varTypeInfo.typeName << ")(uint32_t)" << name << ";" << std::endl;
+				preCallActions << "\t\t" << varTypeInfo.typeName << argName << ";\n";
+				preCallActions << "\t\t" << argName << " = (" << varTypeInfo.typeName << ")(uint32_t)" << name << ";\n";
 			}
 			else
 				argName = name;
@@ -3128,10 +4026,28 @@ std::string generateEventCallbackBodyBlockForParam(const std::string& name, cons
 					std::string interopName = "interop" + name;
 					std::string interopType = getStructInteropType(varTypeInfo.typeName);
 					
-					preCallActions << "\t\t" << interopType << " " << interopName << ";" << std::endl;
-					preCallActions << "\t\t" << interopName << " = " << scriptType << "::toInterop(" << name << ");" << std::endl;
+					preCallActions << "\t\t" << interopType << " " << interopName << ";\n";
+					preCallActions << "\t\t" << interopName << " = " << scriptType << "::toInterop(" << name << ");\n";
 					preCallActions << "\t\t" << argName << " = " << scriptType << "::box(" << interopName << ");\n";
 				}
+				else if (isCachedEventBoxParam(varTypeInfo))
+				{
+					// Copy into the box cached by a previous fire, unless it is in use by a reentrant or concurrent fire
+					std::string handleName = eventName + name + "BoxHandle";
+
+					preCallActions << "\t\tif(cachedBoxes)\n";
+					preCallActions << "\t\t{\n";
+					preCallActions << "\t\t\tif(" << handleName << " == 0)\n";
+					preCallActions << "\t\t\t\t" << handleName << " = MonoUtil::newGCHandle(" << scriptType << "::box(" << 
+						name << "), false);\n";
+					preCallActions << "\n";
+					preCallActions << "\t\t\t" << argName << " = MonoUtil::getObjectFromGCHandle(" << handleName << ");\n";
+					preCallActions << "\t\t\t*(" << varTypeInfo.typeName << "*)MonoUtil::unbox(" << argName << ") = " << 
+						name << ";\n";
+					preCallActions << "\t\t}\n";
+					preCallActions << "\t\telse\n";
+					preCallActions << "\t\t\t" << argName << " = " << scriptType << "::box(" << name << ");\n";
+				}
 				else
 					preCallActions << "\t\t" << argName << " = " << scriptType << "::box(" << name << ");\n";
 			}
@@ -3140,22 +4056,22 @@ std::string generateEventCallbackBodyBlockForParam(const std::string& name, cons
 		case ParsedType::String:
 		{
 			argName = "tmp" + name;
-			preCallActions << "\t\tMonoString* " << argName << ";" << std::endl;
-			preCallActions << "\t\t" << argName << " = MonoUtil::stringToMono(" << name << ");" << std::endl;
+			preCallActions << "\t\tMonoString* " << argName << ";\n";
+			preCallActions << "\t\t" << argName << " = MonoUtil::stringToMono(" << name << ");\n";
 		}
 		break;
 		case ParsedType::WString:
 		{
 			argName = "tmp" + name;
-			preCallActions << "\t\tMonoString* " << argName << ";" << std::endl;
-			preCallActions << "\t\t" << argName << " = MonoUtil::wstringToMono(" << name << ");" << std::endl;
+			preCallActions << "\t\tMonoString* " << argName << ";\n";
+			preCallActions << "\t\t" << argName << " = MonoUtil::wstringToMono(" << name << ");\n";
 		}
 		break;
 		case ParsedType::Path:
 		{
 			argName = "tmp" + name;
-			preCallActions << "\t\tMonoString* " << argName << ";" << std::endl;
-			preCallActions << "\t\t" << argName << " = MonoUtil::stringToMono(" << name << ".toString());" << std::endl;
+			preCallActions << "\t\tMonoString* " << argName << ";\n";
+			preCallActions << "\t\t" << argName << " = MonoUtil::stringToMono(" << name << ".toString());\n";
 		}
 		break;
 		case ParsedType::MonoObject:
@@ -3177,14 +4093,14 @@ std::string generateEventCallbackBodyBlockForParam(const std::string& name, cons
 		default: // Some resource or game object type
 		{
 			argName = "tmp" + name;
-			preCallActions << "\t\tMonoObject* " << argName << ";" << std::endl;
+			preCallActions << "\t\tMonoObject* " << argName << ";\n";
 
 			std::string scriptName = "script" + name;
 			std::string scriptType = getScriptInteropType(varTypeInfo.typeName, getPassAsResourceRef(varTypeInfo.flags));
 
 			preCallActions << generateNativeToScriptObjectLine(paramTypeInfo.type, varTypeInfo.flags, scriptName, name);
 			preCallActions << "\t\tif(" << scriptName << " != nullptr)\n";
-			preCallActions << "\t\t\t" << argName << " = " << scriptName << "->getManagedInstance();" << std::endl;
+			preCallActions << "\t\t\t" << argName << " = " << scriptName << "->getManagedInstance();\n";
 			preCallActions << "\t\telse\n";
 			preCallActions << "\t\t\t" << argName << " = nullptr;\n";
 		}
@@ -3214,20 +4130,20 @@ std::string generateEventCallbackBodyBlockForParam(const std::string& name, cons
 		}
 
 		std::string argName = "vec" + name;
-		preCallActions << "\t\tMonoArray* " << argName << ";" << std::endl;
+		preCallActions << "\t\tMonoArray* " << argName << ";\n";
 
 		preCallActions << "\t\tint arraySize" << name << " = ";
 		if (isVector(varTypeInfo.flags) || isSmallVector(varTypeInfo.flags))
-			preCallActions << "(int)value." << name << ".size()";
+			preCallActions << "(int)" << name << ".size()";
 		else
 			preCallActions << varTypeInfo.arraySize;
 		preCallActions << ";\n";
 
 		std::string arrayName = "array" + name;
 		preCallActions << "\t\tScriptArray " << arrayName;
-		preCallActions << " = " << "ScriptArray::create<" << entryType << ">(arraySize" << name << ");" << std::endl;
-		preCallActions << "\t\tfor(int i = 0; i < arraySize" << name << "; i++)" << std::endl;
-		preCallActions << "\t\t{" << std::endl;
+		preCallActions << " = " << "ScriptArray::create<" << entryType << ">(arraySize" << name << ");\n";
+		preCallActions << "\t\tfor(int i = 0; i < arraySize" << name << "; i++)\n";
+		preCallActions << "\t\t{\n";
 
 		switch (paramTypeInfo.type)
 		{
@@ -3235,7 +4151,7 @@ std::string generateEventCallbackBodyBlockForParam(const std::string& name, cons
 		case ParsedType::String:
 		case ParsedType::WString:
 		case ParsedType::Path:
-			preCallActions << "\t\t\t" << arrayName << ".set(i, " << name << "[i]);" << std::endl;
+			preCallActions << "\t\t\t" << arrayName << ".set(i, " << name << "[i]);\n";
 			break;
 		case ParsedType::Enum:
 		{
@@ -3243,9 +4159,9 @@ std::string generateEventCallbackBodyBlockForParam(const std::string& name, cons
 			mapBuiltinTypeToCppType(paramTypeInfo.underlyingType, enumType);
 
 			if(isFlagsEnum(varTypeInfo.flags))
-				preCallActions << "\t\t\t" << arrayName << ".set(i, (" << enumType << ")(uint32_t)" << name << "[i]);" << std::endl;
+				preCallActions << "\t\t\t" << arrayName << ".set(i, (" << enumType << ")(uint32_t)" << name << "[i]);\n";
 			else
-				preCallActions << "\t\t\t" << arrayName << ".set(i, (" << enumType << ")" << name << "[i]);" << std::endl;
+				preCallActions << "\t\t\t" << arrayName << ".set(i, (" << enumType << ")" << name << "[i]);\n";
 			break;
 		}
 		case ParsedType::Struct:
@@ -3262,7 +4178,7 @@ std::string generateEventCallbackBodyBlockForParam(const std::string& name, cons
 			preCallActions << ");\n";
 			break;
 		case ParsedType::MonoObject:
-			preCallActions << "\t\t\t\t" << arrayName << ".set(i, " << name << "[i]);" << std::endl;
+			preCallActions << "\t\t\t\t" << arrayName << ".set(i, " << name << "[i]);\n";
 			break;
 		case ParsedType::Class:
 		case ParsedType::ReflectableClass:
@@ -3271,7 +4187,7 @@ std::string generateEventCallbackBodyBlockForParam(const std::string& name, cons
 			preCallActions << "\t\t\tMonoObject* " << elemName << ";\n";
 			preCallActions << generateClassNativeToScriptObjectLine(varTypeInfo.flags, varTypeInfo.typeName, elemName,
 				entryType, name + "[i]", false, "\t\t\t");
-			preCallActions << "\t\t\t" << arrayName << ".set(i, " << elemName << ");" << std::endl;
+			preCallActions << "\t\t\t" << arrayName << ".set(i, " << elemName << ");\n";
 		}
 		break;
 		default: // Some resource or game object type
@@ -3280,59 +4196,285 @@ std::string generateEventCallbackBodyBlockForParam(const std::string& name, cons
 
 			preCallActions << generateNativeToScriptObjectLine(paramTypeInfo.type, varTypeInfo.flags, scriptName, name + "[i]", "\t\t\t");
 			preCallActions << "\t\t\tif(" << scriptName << "[i] != nullptr)\n";
-			preCallActions << "\t\t\t" << arrayName << ".set(i, " << scriptName << "->getManagedInstance());" << std::endl;
+			preCallActions << "\t\t\t" << arrayName << ".set(i, " << scriptName << "->getManagedInstance());\n";
 			preCallActions << "\t\t\telse\n";
-			preCallActions << "\t\t\t\t" << arrayName << ".set(i, nullptr);" << std::endl;
+			preCallActions << "\t\t\t\t" << arrayName << ".set(i, nullptr);\n";
 		}
 		break;
 		}
 
-		preCallActions << "\t\t}" << std::endl;
-		preCallActions << "\t\t" << argName << " = " << arrayName << ".getInternal();" << std::endl;
+		preCallActions << "\t\t}\n";
+		preCallActions << "\t\t" << argName << " = " << arrayName << ".getInternal();\n";
 
 		return argName;
 	}
 }
 
-std::string generateCppMethodBody(const ClassInfo& classInfo, const MethodInfo& methodInfo, const std::string& sourceClassName,
-	const std::string& interopClassName, ParsedType classType, bool isModule)
+/** Generates a call to the native version of the provided method, on the object wrapped by "thisPtr" if needed. */
+std::string generateCppMethodCall(const ClassInfo& classInfo, const MethodInfo& methodInfo, 
+	const std::string& sourceClassName, ParsedType classType, bool isModule, const std::string& methodArgs)
 {
-	std::string returnAssignment;
-	std::string returnStmt;
-	std::stringstream preCallActions;
-	std::stringstream methodArgs;
-	std::stringstream postCallActions;
-
 	bool isBase = (classInfo.flags & (int)ClassFlags::IsBase) != 0;
-
 	bool isStatic = (methodInfo.flags & (int)MethodFlags::Static) != 0;
-	bool isCtor = (methodInfo.flags & (int)MethodFlags::Constructor) != 0;
 	bool isExternal = (methodInfo.flags & (int)MethodFlags::External) != 0;
 
-	bool returnAsParameter = false;
-	UserTypeInfo returnTypeInfo;
-	if (!methodInfo.returnInfo.typeName.empty() && !isCtor)
+	CodeWriter methodCall(256);
+	if (!isExternal)
 	{
-		returnTypeInfo = getTypeInfo(methodInfo.returnInfo.typeName, methodInfo.returnInfo.flags);
-		if (!canBeReturned(returnTypeInfo.type, methodInfo.returnInfo.flags))
-			returnAsParameter = true;
+		if (isStatic)
+			methodCall << sourceClassName << "::" << methodInfo.sourceName << "(" << methodArgs << ")"; 
+		else if(isModule)
+			methodCall << sourceClassName << "::instance()." << methodInfo.sourceName << "(" << methodArgs << ")";
 		else
 		{
-			std::string returnType = getInteropCppVarType(methodInfo.returnInfo.typeName, returnTypeInfo.type, methodInfo.returnInfo.flags);
-			postCallActions << "\t\t" << returnType << " __output;" << std::endl;
+			methodCall << generateGetInternalLine(sourceClassName, "thisPtr", classType, isBase ? (int)TypeFlags::ReferencesBase : 0);
+			methodCall << "->" << methodInfo.sourceName << "(" << methodArgs << ")";
+		}
+	}
+	else
+	{
+		std::string fullMethodName = methodInfo.externalClass + "::" + methodInfo.sourceName;
+		if (isStatic)
+			methodCall << fullMethodName << "(" << methodArgs << ")";
+		else
+		{
+			methodCall << fullMethodName << "(" << generateGetInternalLine(sourceClassName, "thisPtr", classType, isBase ? (int)TypeFlags::ReferencesBase : 0);
 
-			std::string argName = generateMethodBodyBlockForParam("__output", methodInfo.returnInfo, true, true, preCallActions, postCallActions);
+			if (!methodArgs.empty())
+				methodCall << ", " << methodArgs;
 
-			returnAssignment = argName + " = ";
-			returnStmt = "\t\treturn __output;";
+			methodCall << ")";
 		}
 	}
 
-	for (auto I = methodInfo.paramInfos.begin(); I != methodInfo.paramInfos.end(); ++I)
-	{
-		bool isLast = (I + 1) == methodInfo.paramInfos.end();
+	return methodCall.str();
+}
 
-		std::string argName = generateMethodBodyBlockForParam(I->name, *I, isLast, false, preCallActions, postCallActions);
+/** Checks is the provided type passed to and from managed code without any conversion. */
+bool isScalarInteropType(const VarTypeInfo& varTypeInfo)
+{
+	if (isArrayOrVector(varTypeInfo.flags) || isOutput(varTypeInfo.flags) || isFlagsEnum(varTypeInfo.flags) || 
+		getIsAsyncOp(varTypeInfo.flags) || isSpan(varTypeInfo.flags))
+		return false;
+
+	UserTypeInfo typeInfo = getTypeInfo(varTypeInfo.typeName, varTypeInfo.flags);
+	switch (typeInfo.type)
+	{
+	case ParsedType::Builtin:
+	case ParsedType::Enum:
+		return true;
+	case ParsedType::Struct:
+		return !isComplexStruct(varTypeInfo.flags);
+	default:
+		return false;
+	}
+}
+
+/** 
+ * Checks is the provided method a leaf method, whose parameters and return value are all builtins, enums or plain 
+ * structs. Such methods need no conversion code and can forward the call directly.
+ */
+bool isLeafMethod(const MethodInfo& methodInfo)
+{
+	const int excludedFlags = (int)MethodFlags::Constructor | (int)MethodFlags::FillsBuffer | 
+		(int)MethodFlags::BatchCall | (int)MethodFlags::FieldWrapper | (int)MethodFlags::CSOnly;
+
+	if ((methodInfo.flags & excludedFlags) != 0)
+		return false;
+
+	if (!methodInfo.returnInfo.typeName.empty() && !isScalarInteropType(methodInfo.returnInfo))
+		return false;
+
+	for (auto& paramInfo : methodInfo.paramInfos)
+	{
+		if (!isScalarInteropType(paramInfo))
+			return false;
+	}
+
+	return true;
+}
+
+/** Generates the body of a leaf method (see isLeafMethod()), forwarding the call with no temporaries. */
+void generateCppLeafMethodBody(const ClassInfo& classInfo, const MethodInfo& methodInfo, const std::string& sourceClassName,
+	ParsedType classType, bool isModule, CodeWriter& output)
+{
+	CodeWriter methodArgs(256);
+	for (auto I = methodInfo.paramInfos.begin(); I != methodInfo.paramInfos.end(); ++I)
+	{
+		UserTypeInfo paramTypeInfo = getTypeInfo(I->typeName, I->flags);
+		methodArgs << getAsManagedToCppArgument(I->name, paramTypeInfo.type, I->flags, methodInfo.sourceName);
+
+		if ((I + 1) != methodInfo.paramInfos.end())
+			methodArgs << ", ";
+	}
+
+	std::string call = generateCppMethodCall(classInfo, methodInfo, sourceClassName, classType, isModule, methodArgs.str());
+
+	output << "\t{\n";
+	if (methodInfo.returnInfo.typeName.empty())
+		output << "\t\t" << call << ";\n";
+	else
+	{
+		UserTypeInfo returnTypeInfo = getTypeInfo(methodInfo.returnInfo.typeName, methodInfo.returnInfo.flags);
+		std::string value = getAsCppToInteropArgument(call, returnTypeInfo.type, methodInfo.returnInfo.flags, "return");
+
+		// Plain structs are returned through a parameter
+		if (canBeReturned(returnTypeInfo.type, methodInfo.returnInfo.flags))
+			output << "\t\treturn " << value << ";\n";
+		else
+			output << "\t\t*__output = " << value << ";\n";
+	}
+	output << "\t}\n";
+}
+
+/** 
+ * Generates the body of a batched method variant (see generateBatchOverloads()), calling the original method once for 
+ * every object in the array provided by the first parameter.
+ */
+void generateCppBatchMethodBody(const ClassInfo& classInfo, const MethodInfo& methodInfo, const std::string& sourceClassName,
+	const std::string& interopClassName, ParsedType classType, CodeWriter& output)
+{
+	bool isBase = (classInfo.flags & (int)ClassFlags::IsBase) != 0;
+
+	const VarInfo& objectsInfo = methodInfo.paramInfos[0];
+	std::string objectsArrayName = "array" + objectsInfo.name;
+
+	output << "\t{\n";
+	output << "\t\tif(" << objectsInfo.name << " == nullptr)\n";
+	output << "\t\t\treturn;\n";
+	output << "\n";
+	output << "\t\tScriptArray " << objectsArrayName << "(" << objectsInfo.name << ");\n";
+	output << "\t\tUINT32 count = " << objectsArrayName << ".size();\n";
+
+	// Calls are only made for objects that have arguments provided for all parameters
+	for (auto I = methodInfo.paramInfos.begin() + 1; I != methodInfo.paramInfos.end(); ++I)
+	{
+		std::string arrayName = "array" + I->name;
+
+		output << "\t\tif(" << I->name << " == nullptr)\n";
+		output << "\t\t\treturn;\n";
+		output << "\n";
+		output << "\t\tScriptArray " << arrayName << "(" << I->name << ");\n";
+		output << "\t\tcount = std::min(count, " << arrayName << ".size());\n";
+	}
+
+	output << "\n";
+	output << "\t\tfor(UINT32 i = 0; i < count; i++)\n";
+	output << "\t\t{\n";
+	output << generateManagedToScriptObjectLine("\t\t\t", interopClassName, "thisPtr", objectsArrayName + ".get<MonoObject*>(i)", 
+		classType, isBase ? (int)TypeFlags::ReferencesBase : 0);
+	output << "\t\t\tif(thisPtr == nullptr)\n";
+	output << "\t\t\t\tcontinue;\n";
+	output << "\n";
+
+	// Call the original method, with the arguments at the current index
+	MethodInfo callMethodInfo = methodInfo;
+	callMethodInfo.flags &= ~(int)MethodFlags::Static;
+	callMethodInfo.paramInfos.erase(callMethodInfo.paramInfos.begin());
+
+	CodeWriter methodArgs(256);
+	for (auto I = callMethodInfo.paramInfos.begin(); I != callMethodInfo.paramInfos.end(); ++I)
+	{
+		UserTypeInfo paramTypeInfo = getTypeInfo(I->typeName, I->flags);
+		std::string argName = "arg" + I->name;
+		std::string arrayName = "array" + I->name;
+
+		if (paramTypeInfo.type == ParsedType::Enum)
+		{
+			std::string enumType;
+			mapBuiltinTypeToCppType(paramTypeInfo.underlyingType, enumType);
+
+			output << "\t\t\t" << I->typeName << " " << argName << " = (" << I->typeName << ")" << arrayName << ".get<" << 
+				enumType << ">(i);\n";
+		}
+		else if (paramTypeInfo.type == ParsedType::Struct && isComplexStruct(I->flags))
+		{
+			output << "\t\t\t" << I->typeName << " " << argName << " = " << getScriptInteropType(I->typeName) << 
+				"::fromInterop(" << arrayName << ".get<" << getStructInteropType(I->typeName) << ">(i));\n";
+		}
+		else
+			output << "\t\t\t" << I->typeName << " " << argName << " = " << arrayName << ".get<" << I->typeName << ">(i);\n";
+
+		methodArgs << getAsManagedToCppArgumentPlain(argName, I->flags, false, methodInfo.sourceName);
+
+		if ((I + 1) != callMethodInfo.paramInfos.end())
+			methodArgs << ", ";
+	}
+
+	output << "\t\t\t" << generateCppMethodCall(classInfo, callMethodInfo, sourceClassName, classType, false, 
+		methodArgs.str()) << ";\n";
+	output << "\t\t}\n";
+	output << "\t}\n";
+}
+
+void generateCppMethodBody(const ClassInfo& classInfo, const MethodInfo& methodInfo, const std::string& sourceClassName,
+	const std::string& interopClassName, ParsedType classType, bool isModule, CodeWriter& output, bool allowLeafCall = true)
+{
+	if (isBatchCall(methodInfo.flags))
+	{
+		generateCppBatchMethodBody(classInfo, methodInfo, sourceClassName, interopClassName, classType, output);
+		return;
+	}
+
+	if (allowLeafCall && isLeafMethod(methodInfo))
+	{
+		generateCppLeafMethodBody(classInfo, methodInfo, sourceClassName, classType, isModule, output);
+		return;
+	}
+
+	std::string returnAssignment;
+	std::string returnStmt;
+	CodeWriter preCallActions;
+	CodeWriter methodArgs(256);
+	CodeWriter postCallActions;
+
+	bool isCtor = (methodInfo.flags & (int)MethodFlags::Constructor) != 0;
+	bool isExternal = (methodInfo.flags & (int)MethodFlags::External) != 0;
+
+	bool returnAsParameter = false;
+	UserTypeInfo returnTypeInfo;
+	if (fillsBuffer(methodInfo.flags))
+	{
+		returnTypeInfo = getTypeInfo(methodInfo.returnInfo.typeName, methodInfo.returnInfo.flags);
+
+		std::string argName = generateMethodBodyBlockForParam("__buffer", methodInfo.returnInfo, true, true, preCallActions, 
+			postCallActions, true);
+
+		returnAssignment = argName + " = ";
+		returnStmt = "\t\treturn arraySize__buffer;";
+	}
+	else if (!methodInfo.returnInfo.typeName.empty() && !isCtor)
+	{
+		returnTypeInfo = getTypeInfo(methodInfo.returnInfo.typeName, methodInfo.returnInfo.flags);
+		if (!canBeReturned(returnTypeInfo.type, methodInfo.returnInfo.flags))
+			returnAsParameter = true;
+		else
+		{
+			std::string returnType = getInteropCppVarType(methodInfo.returnInfo.typeName, returnTypeInfo.type, methodInfo.returnInfo.flags);
+			postCallActions << "\t\t" << returnType << " __output;\n";
+
+			std::string argName = generateMethodBodyBlockForParam("__output", methodInfo.returnInfo, true, true, preCallActions, postCallActions);
+
+			returnAssignment = argName + " = ";
+			returnStmt = "\t\treturn __output;";
+		}
+	}
+
+	for (auto I = methodInfo.paramInfos.begin(); I != methodInfo.paramInfos.end(); ++I)
+	{
+		bool isLast = (I + 1) == methodInfo.paramInfos.end();
+
+		if (isSpan(I->flags))
+		{
+			methodArgs << generateSpanBlockForParam(I->name, *I, isLast, preCallActions);
+
+			if (!isLast)
+				methodArgs << ", ";
+
+			continue;
+		}
+
+		std::string argName = generateMethodBodyBlockForParam(I->name, *I, isLast, false, preCallActions, postCallActions);
 
 		if (!isArrayOrVector(I->flags))
 		{
@@ -3354,8 +4496,7 @@ std::string generateCppMethodBody(const ClassInfo& classInfo, const MethodInfo&
 		returnAssignment = argName + " = ";
 	}
 
-	std::stringstream output;
-	output << "\t{" << std::endl;
+	output << "\t{\n";
 	output << preCallActions.str();
 
 	if (isCtor)
@@ -3365,8 +4506,8 @@ std::string generateCppMethodBody(const ClassInfo& classInfo, const MethodInfo&
 		{
 			if (isClassType(classType))
 			{
-				output << "\t\tSPtr<" << sourceClassName << "> instance = bs_shared_ptr_new<" << sourceClassName << ">(" << methodArgs.str() << ");" << std::endl;
-				output << "\t\tnew (bs_alloc<" << interopClassName << ">())" << interopClassName << "(managedInstance, instance);" << std::endl;
+				output << "\t\tSPtr<" << sourceClassName << "> instance = bs_shared_ptr_new<" << sourceClassName << ">(" << methodArgs.str() << ");\n";
+				output << "\t\t" << generateWrapperAllocation(interopClassName, classType, "managedInstance, instance") << ";\n";
 				isValid = true;
 			}
 		}
@@ -3376,20 +4517,20 @@ std::string generateCppMethodBody(const ClassInfo& classInfo, const MethodInfo&
 
 			if (isClassType(classType))
 			{
-				output << "\t\tSPtr<" << sourceClassName << "> instance = " << fullMethodName << "(" << methodArgs.str() << ");" << std::endl;
-				output << "\t\tnew (bs_alloc<" << interopClassName << ">())" << interopClassName << "(managedInstance, instance);" << std::endl;
+				output << "\t\tSPtr<" << sourceClassName << "> instance = " << fullMethodName << "(" << methodArgs.str() << ");\n";
+				output << "\t\t" << generateWrapperAllocation(interopClassName, classType, "managedInstance, instance") << ";\n";
 				isValid = true;
 			}
 			else if (classType == ParsedType::Resource)
 			{
-				output << "\t\tResourceHandle<" << sourceClassName << "> instance = " << fullMethodName << "(" << methodArgs.str() << ");" << std::endl;
-				output << "\t\tScriptResourceManager::instance().createBuiltinScriptResource(instance, managedInstance);" << std::endl;
+				output << "\t\tResourceHandle<" << sourceClassName << "> instance = " << fullMethodName << "(" << methodArgs.str() << ");\n";
+				output << "\t\tScriptResourceManager::instance().createBuiltinScriptResource(instance, managedInstance);\n";
 				isValid = true;
 			}
 			else if (classType == ParsedType::GUIElement)
 			{
-				output << "\t\t" << sourceClassName << "* instance = " << fullMethodName << "(" << methodArgs.str() << ");" << std::endl;
-				output << "\t\tnew (bs_alloc<" << interopClassName << ">())" << interopClassName << "(managedInstance, instance);" << std::endl;
+				output << "\t\t" << sourceClassName << "* instance = " << fullMethodName << "(" << methodArgs.str() << ");\n";
+				output << "\t\t" << generateWrapperAllocation(interopClassName, classType, "managedInstance, instance") << ";\n";
 				isValid = true;
 			}
 		}
@@ -3399,79 +4540,46 @@ std::string generateCppMethodBody(const ClassInfo& classInfo, const MethodInfo&
 	}
 	else
 	{
-		std::stringstream methodCall;
-		if (!isExternal)
-		{
-			if (isStatic)
-				methodCall << sourceClassName << "::" << methodInfo.sourceName << "(" << methodArgs.str() << ")"; 
-			else if(isModule)
-				methodCall << sourceClassName << "::instance()." << methodInfo.sourceName << "(" << methodArgs.str() << ")";
-			else
-			{
-				methodCall << generateGetInternalLine(sourceClassName, "thisPtr", classType, isBase ? (int)TypeFlags::ReferencesBase : 0);
-				methodCall << "->" << methodInfo.sourceName << "(" << methodArgs.str() << ")";
-			}
-		}
-		else
-		{
-			std::string fullMethodName = methodInfo.externalClass + "::" + methodInfo.sourceName;
-			if (isStatic)
-				methodCall << fullMethodName << "(" << methodArgs.str() << ")";
-			else
-			{
-				methodCall << fullMethodName << "(" << generateGetInternalLine(sourceClassName, "thisPtr", classType, isBase ? (int)TypeFlags::ReferencesBase : 0);
-
-				std::string methodArgsStr = methodArgs.str();
-				if (!methodArgsStr.empty())
-					methodCall << ", " << methodArgsStr;
-
-				methodCall << ")";
-			}
-		}
+		std::string methodCall = generateCppMethodCall(classInfo, methodInfo, sourceClassName, classType, isModule, 
+			methodArgs.str());
 
 		std::string call;
 		if (!methodInfo.returnInfo.typeName.empty())
 		{
-			// Dereference input if needed
-			if (isClassType(returnTypeInfo.type) && !isArrayOrVector(methodInfo.returnInfo.flags))
-			{
-				if ((isSrcPointer(methodInfo.returnInfo.flags) || isSrcReference(methodInfo.returnInfo.flags) || 
-					isSrcValue(methodInfo.returnInfo.flags)) && !isSrcSPtr(methodInfo.returnInfo.flags))
-					returnAssignment = "*" + returnAssignment;
-			}
+			std::string returnValue = getAsCppToInteropArgument(methodCall, returnTypeInfo.type, methodInfo.returnInfo.flags, 
+				"return");
 
-			call = getAsCppToInteropArgument(methodCall.str(), returnTypeInfo.type, methodInfo.returnInfo.flags, "return");
+			call = generateReturnValueAssignment(returnAssignment, returnValue, methodInfo.returnInfo, returnTypeInfo.type);
 		}
 		else
-			call = methodCall.str();
+			call = methodCall;
 
-		output << "\t\t" << returnAssignment << call << ";\n";
+		output << "\t\t" << call << ";\n";
 	}
 
 	std::string postCallActionsStr = postCallActions.str();
 	if (!postCallActionsStr.empty())
-		output << std::endl;
+		output << "\n";
 
 	output << postCallActionsStr;
 
 	if (!returnStmt.empty())
 	{
-		output << std::endl;
-		output << returnStmt << std::endl;
+		output << "\n";
+		output << returnStmt << "\n";
 	}
 
-	output << "\t}" << std::endl;
-	return output.str();
+	output << "\t}\n";
 }
 
-std::string generateCppFieldGetterBody(const ClassInfo& classInfo, const FieldInfo& fieldInfo, const MethodInfo& methodInfo,	
-	ParsedType classType, bool isModule)
+void generateCppFieldGetterBody(const ClassInfo& classInfo, const FieldInfo& fieldInfo, const MethodInfo& methodInfo,	
+	ParsedType classType, bool isModule, CodeWriter& output)
 {
 	std::string returnAssignment;
 	std::string returnStmt;
-	std::stringstream preCallActions;
-	std::stringstream methodArgs;
-	std::stringstream postCallActions;
+	CodeWriter preCallActions;
+	CodeWriter methodArgs(256);
+	CodeWriter postCallActions;
 
 	bool isBase = (classInfo.flags & (int)ClassFlags::IsBase) != 0;
 	bool isStatic = (methodInfo.flags & (int)MethodFlags::Static) != 0;
@@ -3483,7 +4591,7 @@ std::string generateCppFieldGetterBody(const ClassInfo& classInfo, const FieldIn
 	else
 	{
 		std::string returnType = getInteropCppVarType(methodInfo.returnInfo.typeName, returnTypeInfo.type, methodInfo.returnInfo.flags);
-		postCallActions << "\t\t" << returnType << " __output;" << std::endl;
+		postCallActions << "\t\t" << returnType << " __output;\n";
 
 		std::string argName = generateMethodBodyBlockForParam("__output", methodInfo.returnInfo, true, true, preCallActions, postCallActions);
 
@@ -3498,11 +4606,10 @@ std::string generateCppFieldGetterBody(const ClassInfo& classInfo, const FieldIn
 		returnAssignment = argName + " = ";
 	}
 
-	std::stringstream output;
-	output << "\t{" << std::endl;
+	output << "\t{\n";
 	output << preCallActions.str();
 
-	std::stringstream fieldAccess;
+	CodeWriter fieldAccess(256);
 	if (isStatic)
 		fieldAccess << classInfo.name << "::" << fieldInfo.name; 
 	else if(isModule)
@@ -3513,37 +4620,28 @@ std::string generateCppFieldGetterBody(const ClassInfo& classInfo, const FieldIn
 		fieldAccess << "->" << fieldInfo.name;
 	}
 
-	// Dereference input if needed
-	if (isClassType(returnTypeInfo.type) && !isArrayOrVector(methodInfo.returnInfo.flags))
-	{
-		if ((isSrcPointer(methodInfo.returnInfo.flags) || isSrcReference(methodInfo.returnInfo.flags) || 
-			isSrcValue(methodInfo.returnInfo.flags)) && !isSrcSPtr(methodInfo.returnInfo.flags))
-			returnAssignment = "*" + returnAssignment;
-	}
-
 	std::string access = getAsCppToInteropArgument(fieldAccess.str(), returnTypeInfo.type, methodInfo.returnInfo.flags, "return");
 
-	output << "\t\t" << returnAssignment << access << ";\n";
+	output << "\t\t" << generateReturnValueAssignment(returnAssignment, access, methodInfo.returnInfo, returnTypeInfo.type) << ";\n";
 
 	std::string postCallActionsStr = postCallActions.str();
 	if (!postCallActionsStr.empty())
-		output << std::endl;
+		output << "\n";
 
 	output << postCallActionsStr;
 
-	output << std::endl;
-	output << returnStmt << std::endl;
+	output << "\n";
+	output << returnStmt << "\n";
 
-	output << "\t}" << std::endl;
-	return output.str();
+	output << "\t}\n";
 }
 
-std::string generateCppFieldSetterBody(const ClassInfo& classInfo, const FieldInfo& fieldInfo, const MethodInfo& methodInfo,
-	ParsedType classType, bool isModule)
+void generateCppFieldSetterBody(const ClassInfo& classInfo, const FieldInfo& fieldInfo, const MethodInfo& methodInfo,
+	ParsedType classType, bool isModule, CodeWriter& output)
 {
-	std::stringstream preCallActions;
-	std::stringstream argValue;
-	std::stringstream postCallActions;
+	CodeWriter preCallActions;
+	CodeWriter argValue(256);
+	CodeWriter postCallActions;
 
 	bool isBase = (classInfo.flags & (int)ClassFlags::IsBase) != 0;
 	bool isStatic = (methodInfo.flags & (int)MethodFlags::Static) != 0;
@@ -3558,11 +4656,10 @@ std::string generateCppFieldSetterBody(const ClassInfo& classInfo, const FieldIn
 	else
 		argValue << argName;
 
-	std::stringstream output;
-	output << "\t{" << std::endl;
+	output << "\t{\n";
 	output << preCallActions.str();
 
-	std::stringstream fieldAccess;
+	CodeWriter fieldAccess(256);
 	if (isStatic)
 		fieldAccess << classInfo.name << "::" << fieldInfo.name; 
 	else if(isModule)
@@ -3577,18 +4674,147 @@ std::string generateCppFieldSetterBody(const ClassInfo& classInfo, const FieldIn
 
 	std::string postCallActionsStr = postCallActions.str();
 	if (!postCallActionsStr.empty())
-		output << std::endl;
+		output << "\n";
 
 	output << postCallActionsStr;
 
-	output << "\t}" << std::endl;
+	output << "\t}\n";
+}
+
+/** 
+ * Generates an expression that looks up the thunk used for triggering the managed callback of the provided event. Deferred
+ * events must be provided with their deferred signature (see getDeferredEventInfo()).
+ */
+std::string generateCppEventThunkLookup(const MethodInfo& eventInfo)
+{
+	CodeWriter output(256);
+	output << "(" << eventInfo.sourceName << "ThunkDef)metaData.scriptClass->getMethodExact(";
+	output << "\"Internal_" << eventInfo.interopName << "\", \"";
+
+	for (auto I = eventInfo.paramInfos.begin(); I != eventInfo.paramInfos.end(); ++I)
+	{
+		const VarInfo& paramInfo = *I;
+		UserTypeInfo paramTypeInfo = getTypeInfo(paramInfo.typeName, paramInfo.flags);
+
+		std::string typeName;
+
+		// Generic types require `X after their name
+		StringRef inputStr(paramTypeInfo.scriptName.data(), paramTypeInfo.scriptName.length());
+		inputStr = inputStr.trim();
+
+		const size_t leftBracketIdx = inputStr.find_first_of('<');
+		const size_t rightBracketIdx = inputStr.find_last_of('>');
+		const size_t numLeftBrackets = inputStr.count('<');
+		const size_t numRightBrackets = inputStr.count('>');
+
+		if (numLeftBrackets > 1 || numRightBrackets > 1)
+		{
+			outs() << "Error: Cannot parse event signature type. Nested generic parameters are not allowed.\n";
+			typeName = paramTypeInfo.scriptName;
+		}
+		else if (leftBracketIdx != StringRef::npos && rightBracketIdx != StringRef::npos)
+		{
+			StringRef templateType = inputStr.substr(0, leftBracketIdx);
+			StringRef templateArgs = inputStr.substr(leftBracketIdx + 1, rightBracketIdx - leftBracketIdx - 1);
+			const size_t numTemplateArgs = templateArgs.count(',') + 1;
+
+			typeName = templateType.str() + "`" + std::to_string(numTemplateArgs) + "<" + templateArgs.str() + ">";
+		}
+		else
+			typeName = paramTypeInfo.scriptName;
+
+		if(typeName == "float")
+			typeName = "single";
+
+		std::string csType = getCSVarType(typeName, paramTypeInfo.type, paramInfo.flags, true, true, true, true);
+
+		output << csType;
+
+		if ((I + 1) != eventInfo.paramInfos.end())
+			output << ",";
+	}
+
+	output << "\")->getThunk()";
+
 	return output.str();
 }
 
-std::string generateCppEventCallbackBody(const MethodInfo& eventInfo, bool isModule)
+/** Returns the type used for storing the provided event parameter in the queue of a deferred event. */
+std::string getDeferredEventParamType(const VarInfo& paramInfo)
+{
+	UserTypeInfo paramTypeInfo = getTypeInfo(paramInfo.typeName, paramInfo.flags);
+	return getCppVarType(paramInfo.typeName, paramTypeInfo.type, paramInfo.flags, false);
+}
+
+/** 
+ * Generates the body of the event callback for a deferred event. Instead of calling into managed code, the event
+ * parameters are appended to the event queue, to be delivered on the next flush.
+ */
+void generateCppDeferredEventCallbackBody(const MethodInfo& eventInfo, CodeWriter& output)
+{
+	std::string queueName = eventInfo.sourceName + "Queue";
+
+	output << "\t{\n";
+	output << "\t\tLock lock(" << queueName << "Mutex);\n";
+
+	if (isCoalesced(eventInfo.flags))
+	{
+		output << "\n";
+		output << "\t\t// Merge identical consecutive fires\n";
+
+		if (eventInfo.paramInfos.empty())
+		{
+			output << "\t\tif(!" << queueName << ".empty())\n";
+			output << "\t\t\treturn;\n";
+		}
+		else
+		{
+			output << "\t\tif(!" << queueName << ".empty())\n";
+			output << "\t\t{\n";
+			output << "\t\t\tconst " << eventInfo.sourceName << "Fire& last = " << queueName << ".back();\n";
+			output << "\t\t\tif(";
+
+			for (auto I = eventInfo.paramInfos.begin(); I != eventInfo.paramInfos.end(); ++I)
+			{
+				if (I != eventInfo.paramInfos.begin())
+					output << " && ";
+
+				output << "last." << I->name << " == " << I->name;
+			}
+
+			output << ")\n";
+			output << "\t\t\t\treturn;\n";
+			output << "\t\t}\n";
+		}
+
+		output << "\n";
+	}
+
+	output << "\t\t" << queueName << ".push_back({ ";
+
+	for (auto I = eventInfo.paramInfos.begin(); I != eventInfo.paramInfos.end(); ++I)
+	{
+		if (I != eventInfo.paramInfos.begin())
+			output << ", ";
+
+		output << I->name;
+	}
+
+	output << " });\n";
+	output << "\t}\n";
+}
+
+void generateCppEventCallbackBody(const MethodInfo& eventInfo, bool isModule, CodeWriter& output, 
+	const std::string& preamble = "")
 {
-	std::stringstream preCallActions;
-	std::stringstream methodArgs;
+	if (isDeferred(eventInfo.flags))
+	{
+		generateCppDeferredEventCallbackBody(eventInfo, output);
+		return;
+	}
+
+	CodeWriter preCallActions;
+	CodeWriter methodArgs(256);
 
 	bool isStatic = (eventInfo.flags & (int)MethodFlags::Static) != 0;
 
@@ -3597,7 +4823,7 @@ std::string generateCppEventCallbackBody(const MethodInfo& eventInfo, bool isMod
 	{
 		bool isLast = (I + 1) == eventInfo.paramInfos.end();
 
-		std::string argName = generateEventCallbackBodyBlockForParam(I->name, *I, preCallActions);
+		std::string argName = generateEventCallbackBodyBlockForParam(I->name, *I, eventInfo.sourceName, preCallActions);
 
 		if (!isArrayOrVector(I->flags))
 		{
@@ -3617,11 +4843,36 @@ std::string generateCppEventCallbackBody(const MethodInfo& eventInfo, bool isMod
 		idx++;
 	}
 
-	std::stringstream output;
-	output << "\t{" << std::endl;
+	output << "\t{\n";
+	output << preamble;
+
+	// Resolve the thunk on first use. Events can be triggered from any thread, so the thunk is published atomically.
+	// Concurrent first uses might both look it up, which is harmless as they resolve the same thunk.
+	std::string thunkName = eventInfo.sourceName + "Thunk";
+	if (sLazyRuntimeData)
+	{
+		thunkName = "thunk";
+
+		output << "\t\t" << eventInfo.sourceName << "ThunkDef thunk = " << eventInfo.sourceName << 
+			"Thunk.load(std::memory_order_acquire);\n";
+		output << "\t\tif(thunk == nullptr)\n";
+		output << "\t\t{\n";
+		output << "\t\t\tthunk = " << generateCppEventThunkLookup(eventInfo) << ";\n";
+		output << "\t\t\t" << eventInfo.sourceName << "Thunk.store(thunk, std::memory_order_release);\n";
+		output << "\t\t}\n";
+		output << "\n";
+	}
+
+	bool cachedBoxes = hasCachedEventBoxes(eventInfo);
+	if (cachedBoxes)
+	{
+		output << "\t\tbool cachedBoxes = !" << eventInfo.sourceName << 
+			"BoxesInUse.exchange(true, std::memory_order_acquire);\n";
+	}
+
 	output << preCallActions.str();
 
-	output << "\t\tMonoUtil::invokeThunk(" << eventInfo.sourceName << "Thunk";
+	output << "\t\tMonoUtil::invokeThunk(" << thunkName;
 
 	if (!isStatic && !isModule)
 		output << ", getManagedInstance()";
@@ -3631,41 +4882,108 @@ std::string generateCppEventCallbackBody(const MethodInfo& eventInfo, bool isMod
 
 	output << ");\n";
 
-	output << "\t}" << std::endl;
-	return output.str();
+	if (cachedBoxes)
+	{
+		output << "\n";
+		output << "\t\tif(cachedBoxes)\n";
+		output << "\t\t\t" << eventInfo.sourceName << "BoxesInUse.store(false, std::memory_order_release);\n";
+	}
+
+	output << "\t}\n";
 }
 
-std::string generateCppHeaderOutput(const ClassInfo& classInfo, const UserTypeInfo& typeInfo)
+/** Checks does the class have any events whose fires are queued and delivered on flush. */
+bool hasDeferredEvents(const ClassInfo& classInfo)
 {
-	bool inEditor = hasAPIBED (classInfo.api);
-	bool isBase = (classInfo.flags & (int)ClassFlags::IsBase) != 0;
-	bool isModule = (classInfo.flags & (int)ClassFlags::IsModule) != 0;
-	bool isRootBase = classInfo.baseClass.empty();
-
-	bool hasStaticEvents = isModule && !classInfo.eventInfos.empty();
-	if (!hasStaticEvents)
+	for (auto& eventInfo : classInfo.eventInfos)
 	{
-		for (auto& eventInfo : classInfo.eventInfos)
-		{
-			bool isStatic = (eventInfo.flags & (int)MethodFlags::Static) != 0;
-			if (isStatic)
-			{
-				hasStaticEvents = true;
-				break;
-			}
-		}
+		if (isDeferred(eventInfo.flags))
+			return true;
 	}
 
-	std::string exportAttr;
-	if (!inEditor)
-		exportAttr = sFrameworkExportMacro;
-	else
-		exportAttr = sEditorExportMacro;
+	return false;
+}
+
+/** 
+ * Generates a method that delivers all queued fires of a deferred event to managed code, using a single call with an
+ * array per event parameter.
+ */
+void generateCppEventFlush(const MethodInfo& eventInfo, const std::string& interopClassName, bool isModule, 
+	CodeWriter& output)
+{
+	std::string fireType = eventInfo.sourceName + "Fire";
+	std::string queueName = eventInfo.sourceName + "Queue";
+
+	// Fires are swapped into a persistent buffer, so both it and the queue keep their capacity between flushes
+	CodeWriter preamble;
+	preamble << "\t\tVector<" << fireType << ">& fires = " << eventInfo.sourceName << "FlushBuffer;\n";
+	preamble << "\t\t{\n";
+	preamble << "\t\t\tLock lock(" << queueName << "Mutex);\n";
+	preamble << "\t\t\tstd::swap(fires, " << queueName << ");\n";
+	preamble << "\t\t}\n";
+	preamble << "\n";
+	preamble << "\t\tif(fires.empty())\n";
+	preamble << "\t\t\treturn;\n";
+	preamble << "\n";
+	preamble << "\t\tint32_t count = (int32_t)fires.size();\n";
+
+	for (auto& paramInfo : eventInfo.paramInfos)
+	{
+		preamble << "\t\tVector<" << getDeferredEventParamType(paramInfo) << "> " << paramInfo.name << ";\n";
+		preamble << "\t\t" << paramInfo.name << ".reserve(fires.size());\n";
+	}
+
+	if (!eventInfo.paramInfos.empty())
+	{
+		preamble << "\n";
+		preamble << "\t\tfor(auto& fire : fires)\n";
+		preamble << "\t\t{\n";
+
+		for (auto& paramInfo : eventInfo.paramInfos)
+			preamble << "\t\t\t" << paramInfo.name << ".push_back(fire." << paramInfo.name << ");\n";
+
+		preamble << "\t\t}\n";
+	}
+
+	// Cleared before calling into managed code, in case the callback flushes again
+	preamble << "\n";
+	preamble << "\t\tfires.clear();\n";
+	preamble << "\n";
+
+	output << "\tvoid " << interopClassName << "::" << eventInfo.sourceName << "Flush()\n";
+	generateCppEventCallbackBody(getDeferredEventInfo(eventInfo), isModule, output, preamble.str());
+}
+
+void generateCppHeaderOutput(const ClassInfo& classInfo, const UserTypeInfo& typeInfo, CodeWriter& output)
+{
+	bool inEditor = hasAPIBED (classInfo.api);
+	bool isBase = (classInfo.flags & (int)ClassFlags::IsBase) != 0;
+	bool isModule = (classInfo.flags & (int)ClassFlags::IsModule) != 0;
+	bool isRootBase = classInfo.baseClass.empty();
+
+	bool hasStaticEvents = isModule && !classInfo.eventInfos.empty();
+	if (!hasStaticEvents)
+	{
+		for (auto& eventInfo : classInfo.eventInfos)
+		{
+			bool isStatic = (eventInfo.flags & (int)MethodFlags::Static) != 0;
+			if (isStatic)
+			{
+				hasStaticEvents = true;
+				break;
+			}
+		}
+	}
+
+	std::string exportAttr;
+	if (!inEditor)
+		exportAttr = sFrameworkExportMacro;
+	else
+		exportAttr = sEditorExportMacro;
 
 	std::string wrappedDataType = getCppVarType(classInfo.name, typeInfo.type);
 	std::string interopBaseClassName;
 
-	std::stringstream output;
 	output << generateCppApiCheckBegin(classInfo.api);
 
 	// Generate a common base class if required
@@ -3696,35 +5014,35 @@ std::string generateCppHeaderOutput(const ClassInfo& classInfo, const UserTypeIn
 				output << parentBaseClassName;
 			}
 
-			output << std::endl;
-			output << "\t{" << std::endl;
-			output << "\tpublic:" << std::endl;
-			output << "\t\t" << interopBaseClassName << "(MonoObject* instance);" << std::endl;
-			output << "\t\tvirtual ~" << interopBaseClassName << "() {}" << std::endl;
+			output << "\n";
+			output << "\t{\n";
+			output << "\tpublic:\n";
+			output << "\t\t" << interopBaseClassName << "(MonoObject* instance);\n";
+			output << "\t\tvirtual ~" << interopBaseClassName << "() {}\n";
 
 			if(!isModule)
 			{
 				if (typeInfo.type == ParsedType::ReflectableClass)
 				{
-					output << std::endl;
+					output << "\n";
 					output << "\t\t" << wrappedDataType << " getInternal() const;\n";
 				}
 				else if (typeInfo.type == ParsedType::Class)
 				{
-					output << std::endl;
-					output << "\t\t" << wrappedDataType << " getInternal() const { return mInternal; }" << std::endl;
+					output << "\n";
+					output << "\t\t" << wrappedDataType << " getInternal() const { return mInternal; }\n";
 
 					// Data member only present in the top-most base class
 					if (isRootBase)
 					{
-						output << "\tprotected:" << std::endl;
-						output << "\t\t" << wrappedDataType << " mInternal;" << std::endl;
+						output << "\tprotected:\n";
+						output << "\t\t" << wrappedDataType << " mInternal;\n";
 					}
 				}
 			}
 
-			output << "\t};" << std::endl;
-			output << std::endl;
+			output << "\t};\n";
+			output << "\n";
 		}
 		else if (!classInfo.baseClass.empty())
 		{
@@ -3754,16 +5072,16 @@ std::string generateCppHeaderOutput(const ClassInfo& classInfo, const UserTypeIn
 
 	output << ">";
 
-	output << std::endl;
-	output << "\t{" << std::endl;
-	output << "\tpublic:" << std::endl;
+	output << "\n";
+	output << "\t{\n";
+	output << "\tpublic:\n";
 
 	if (!inEditor)
-		output << "\t\tSCRIPT_OBJ(ENGINE_ASSEMBLY, ENGINE_NS, \"" << typeInfo.scriptName << "\")" << std::endl;
+		output << "\t\tSCRIPT_OBJ(ENGINE_ASSEMBLY, ENGINE_NS, \"" << typeInfo.scriptName << "\")\n";
 	else
-		output << "\t\tSCRIPT_OBJ(EDITOR_ASSEMBLY, EDITOR_NS, \"" << typeInfo.scriptName << "\")" << std::endl;
+		output << "\t\tSCRIPT_OBJ(EDITOR_ASSEMBLY, EDITOR_NS, \"" << typeInfo.scriptName << "\")\n";
 
-	output << std::endl;
+	output << "\n";
 
 	// Constructor
 	if (!isModule)
@@ -3778,9 +5096,9 @@ std::string generateCppHeaderOutput(const ClassInfo& classInfo, const UserTypeIn
 		output << ");\n";
 	}
 	else
-		output << "\t\t" << interopClassName << "(MonoObject* managedInstance);" << std::endl;
+		output << "\t\t" << interopClassName << "(MonoObject* managedInstance);\n";
 
-	output << std::endl;
+	output << "\n";
 
 	if (typeInfo.type == ParsedType::Class && !isModule)
 	{
@@ -3788,7 +5106,7 @@ std::string generateCppHeaderOutput(const ClassInfo& classInfo, const UserTypeIn
 		if (isBase || !classInfo.baseClass.empty())
 			output << "\t\t" << wrappedDataType << " getInternal() const;\n";
 		else
-			output << "\t\t" << wrappedDataType << " getInternal() const { return mInternal; }" << std::endl;
+			output << "\t\t" << wrappedDataType << " getInternal() const { return mInternal; }\n";
 	}
 
 	if(isClassType(typeInfo.type) && !isModule)
@@ -3798,26 +5116,40 @@ std::string generateCppHeaderOutput(const ClassInfo& classInfo, const UserTypeIn
 			output << "\t\tMonoObject* getManagedInstance() const;\n";
 
 		// create() method
-		output << "\t\tstatic MonoObject* create(const " << wrappedDataType << "& value);" << std::endl;
-		output << std::endl;
+		output << "\t\tstatic MonoObject* create(const " << wrappedDataType << "& value);\n";
+		output << "\n";
+	}
+
+	// Pooled wrappers must be returned to the pool they were allocated from
+	if (usesPooledWrapperAllocation(typeInfo.type, isModule))
+	{
+		output << "\t\tvoid _onManagedInstanceDeleted(bool assemblyRefresh) override;\n";
+		output << "\n";
 	}
 
 	if (typeInfo.type == ParsedType::Resource)
 	{
 		// createInstance() method required by script resource manager
-		output << "\t\tstatic MonoObject* createInstance();" << std::endl;
-		output << std::endl;
+		output << "\t\tstatic MonoObject* createInstance();\n";
+		output << "\n";
 	}
 
 	// Static start-up and shut-down methods, if required
 	if(hasStaticEvents)
 	{
-		output << "\t\tstatic void startUp();" << std::endl;
-		output << "\t\tstatic void shutDown();" << std::endl;
-		output << std::endl;
+		output << "\t\tstatic void startUp();\n";
+		output << "\t\tstatic void shutDown();\n";
+		output << "\n";
+	}
+
+	// Delivers queued fires of all deferred events
+	if(hasDeferredEvents(classInfo))
+	{
+		output << "\t\tstatic void flushEvents();\n";
+		output << "\n";
 	}
 
-	output << "\tprivate:" << std::endl;
+	output << "\tprivate:\n";
 
 	// Handle (if required)
 	if (isClassType(typeInfo.type))
@@ -3830,18 +5162,18 @@ std::string generateCppHeaderOutput(const ClassInfo& classInfo, const UserTypeIn
 	for (auto& eventInfo : classInfo.eventInfos)
 	{
 		output << generateCppApiCheckBegin(eventInfo.api);
-		output << "\t\t" << generateCppEventCallbackSignature(eventInfo, "", isModule) << ";" << std::endl;
+		output << "\t\t" << generateCppEventCallbackSignature(eventInfo, "", isModule) << ";\n";
 		output << generateApiCheckEnd(eventInfo.api);
 	}
 
 	if(!classInfo.eventInfos.empty())
-		output << std::endl;
+		output << "\n";
 
 	// Data member
 	if (typeInfo.type == ParsedType::Class && !isModule && classInfo.baseClass.empty() && !isBase)
 	{
-		output << "\t\t" << wrappedDataType << " mInternal;" << std::endl;
-		output << std::endl;
+		output << "\t\t" << wrappedDataType << " mInternal;\n";
+		output << "\n";
 	}
 
 	// Event thunks
@@ -3853,7 +5185,7 @@ std::string generateCppHeaderOutput(const ClassInfo& classInfo, const UserTypeIn
 	}
 
 	if(!classInfo.eventInfos.empty())
-		output << std::endl;
+		output << "\n";
 
 	// Event handles
 	for (auto& eventInfo : classInfo.eventInfos)
@@ -3863,13 +5195,36 @@ std::string generateCppHeaderOutput(const ClassInfo& classInfo, const UserTypeIn
 		if(!isCallback && (isStatic || isModule))
 		{
 			output << generateCppApiCheckBegin(eventInfo.api);
-			output << "\t\tstatic HEvent " << eventInfo.sourceName << "Conn;" << std::endl;
+			output << "\t\tstatic HEvent " << eventInfo.sourceName << "Conn;\n";
 			output << generateApiCheckEnd(eventInfo.api);
 		}
 	}
 
 	if(hasStaticEvents)
-		output << std::endl;
+		output << "\n";
+
+	// Event queues
+	for (auto& eventInfo : classInfo.eventInfos)
+	{
+		if (!isDeferred(eventInfo.flags))
+			continue;
+
+		output << generateCppApiCheckBegin(eventInfo.api);
+		output << "\t\tstruct " << eventInfo.sourceName << "Fire\n";
+		output << "\t\t{\n";
+
+		for (auto& paramInfo : eventInfo.paramInfos)
+			output << "\t\t\t" << getDeferredEventParamType(paramInfo) << " " << paramInfo.name << ";\n";
+
+		output << "\t\t};\n";
+		output << "\n";
+		output << "\t\tstatic void " << eventInfo.sourceName << "Flush();\n";
+		output << "\t\tstatic Vector<" << eventInfo.sourceName << "Fire> " << eventInfo.sourceName << "Queue;\n";
+		output << "\t\tstatic Vector<" << eventInfo.sourceName << "Fire> " << eventInfo.sourceName << "FlushBuffer;\n";
+		output << "\t\tstatic Mutex " << eventInfo.sourceName << "QueueMutex;\n";
+		output << generateApiCheckEnd(eventInfo.api);
+		output << "\n";
+	}
 
 	// CLR hooks
 	std::string interopClassThisPtrType;
@@ -3893,7 +5248,7 @@ std::string generateCppHeaderOutput(const ClassInfo& classInfo, const UserTypeIn
 			continue;
 
 		output << generateCppApiCheckBegin(methodInfo.api);
-		output << "\t\tstatic " << generateCppMethodSignature(methodInfo, interopClassThisPtrType, "", isModule) << ";" << std::endl;
+		output << "\t\tstatic " << generateCppMethodSignature(methodInfo, interopClassThisPtrType, "", isModule) << ";\n";
 		output << generateApiCheckEnd(methodInfo.api);
 	}
 
@@ -3903,17 +5258,25 @@ std::string generateCppHeaderOutput(const ClassInfo& classInfo, const UserTypeIn
 			continue;
 
 		output << generateCppApiCheckBegin(methodInfo.api);
-		output << "\t\tstatic " << generateCppMethodSignature(methodInfo, interopClassThisPtrType, "", isModule) << ";" << std::endl;
+		output << "\t\tstatic " << generateCppMethodSignature(methodInfo, interopClassThisPtrType, "", isModule) << ";\n";
 		output << generateApiCheckEnd(methodInfo.api);
 	}
 
-	output << "\t};" << std::endl;
-	output << generateApiCheckEnd(classInfo.api);
+	output << "\t};\n";
 
-	return output.str();
+	if (usesPooledWrapperAllocation(typeInfo.type, isModule))
+	{
+		// Note: Same as IMPLEMENT_GLOBAL_POOL, except the pool is locked. Wrappers are allocated on the main thread, but 
+		// freed when their managed instance is finalized, which can happen on the finalizer thread.
+		output << "\n";
+		output << "\ttemplate<> class GlobalPoolAlloc<" << interopClassName << "> : public PoolAlloc<sizeof(" << 
+			interopClassName << "), 128, 4, true> { };\n";
+	}
+
+	output << generateApiCheckEnd(classInfo.api);
 }
 
-std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeInfo& typeInfo)
+void generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeInfo& typeInfo, CodeWriter& output)
 {
 	bool isBase = (classInfo.flags & (int)ClassFlags::IsBase) != 0;
 	bool isModule = (classInfo.flags & (int)ClassFlags::IsModule) != 0;
@@ -3942,7 +5305,6 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 			interopBaseClassName = getScriptInteropType(classInfo.baseClass) + "Base";
 	}
 
-	std::stringstream output;
 	output << generateCppApiCheckBegin(classInfo.api);
 
 	if (isBase && typeInfo.type != ParsedType::GUIElement)
@@ -3987,7 +5349,28 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 	for (auto& eventInfo : classInfo.eventInfos)
 	{
 		output << generateCppApiCheckBegin(eventInfo.api);
-		output << "\t" << interopClassName << "::" << eventInfo.sourceName << "ThunkDef " << interopClassName << "::" << eventInfo.sourceName << "Thunk; \n";
+		if (sLazyRuntimeData)
+		{
+			output << "\tstd::atomic<" << interopClassName << "::" << eventInfo.sourceName << "ThunkDef> " << 
+				interopClassName << "::" << eventInfo.sourceName << "Thunk; \n";
+		}
+		else
+			output << "\t" << interopClassName << "::" << eventInfo.sourceName << "ThunkDef " << interopClassName << "::" << eventInfo.sourceName << "Thunk; \n";
+
+		if (hasCachedEventBoxes(eventInfo))
+		{
+			output << "\tstd::atomic<bool> " << interopClassName << "::" << eventInfo.sourceName << "BoxesInUse;\n";
+
+			for (auto& paramInfo : eventInfo.paramInfos)
+			{
+				if (isCachedEventBoxParam(paramInfo))
+				{
+					output << "\tUINT32 " << interopClassName << "::" << eventInfo.sourceName << paramInfo.name << 
+						"BoxHandle = 0;\n";
+				}
+			}
+		}
+
 		output << generateApiCheckEnd(eventInfo.api);
 	}
 
@@ -4013,6 +5396,26 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 	if (hasEventHandles)
 		output << "\n";
 
+	// Event queues
+	if (hasDeferredEvents(classInfo))
+	{
+		for (auto& eventInfo : classInfo.eventInfos)
+		{
+			if (!isDeferred(eventInfo.flags))
+				continue;
+
+			output << generateCppApiCheckBegin(eventInfo.api);
+			output << "\tVector<" << interopClassName << "::" << eventInfo.sourceName << "Fire> " << interopClassName << 
+				"::" << eventInfo.sourceName << "Queue;\n";
+			output << "\tVector<" << interopClassName << "::" << eventInfo.sourceName << "Fire> " << interopClassName << 
+				"::" << eventInfo.sourceName << "FlushBuffer;\n";
+			output << "\tMutex " << interopClassName << "::" << eventInfo.sourceName << "QueueMutex;\n";
+			output << generateApiCheckEnd(eventInfo.api);
+		}
+
+		output << "\n";
+	}
+
 	// Constructor
 	if (!isModule)
 	{
@@ -4026,7 +5429,7 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 		output << ")\n";
 	}
 	else
-		output << "\t" << interopClassName << "::" << interopClassName << "(MonoObject* managedInstance)" << std::endl;
+		output << "\t" << interopClassName << "::" << interopClassName << "(MonoObject* managedInstance)\n";
 
 	output << "\t\t:";
 
@@ -4050,8 +5453,8 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 		else
 			output << "ScriptObject(managedInstance)";
 	}
-	output << std::endl;
-	output << "\t{" << std::endl;
+	output << "\n";
+	output << "\t{\n";
 
 	if (isClassType(typeInfo.type))
 	{
@@ -4078,10 +5481,7 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 				else
 					output << "\t\tvalue->" << eventInfo.sourceName << " = ";
 
-				output << "std::bind(&" << interopClassName << "::" << eventInfo.interopName << ", this";
-
-				for (int i = 0; i < (int)eventInfo.paramInfos.size(); i++)
-					output << ", std::placeholders::_" << (i + 1);
+				output << generateCppEventCallbackLambda(eventInfo);
 
 				if (!isCallback)
 					output << ")";
@@ -4092,8 +5492,8 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 		}
 	}
 
-	output << "\t}" << std::endl;
-	output << std::endl;
+	output << "\t}\n";
+	output << "\n";
 
 	if (typeInfo.type == ParsedType::Class)
 	{
@@ -4120,8 +5520,8 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 	}
 
 	// CLR hook registration
-	output << "\tvoid " << interopClassName << "::initRuntimeData()" << std::endl;
-	output << "\t{" << std::endl;
+	output << "\tvoid " << interopClassName << "::initRuntimeData()\n";
+	output << "\t{\n";
 
 	// Internal_GetRef interop method
 	if (typeInfo.type == ParsedType::Resource)
@@ -4137,7 +5537,7 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 
 		output << generateCppApiCheckBegin(methodInfo.api);
 		output << "\t\tmetaData.scriptClass->addInternalCall(\"Internal_" << methodInfo.interopName << "\", (void*)&" <<
-			interopClassName << "::Internal_" << methodInfo.interopName << ");" << std::endl;
+			interopClassName << "::Internal_" << methodInfo.interopName << ");\n";
 		output << generateApiCheckEnd(methodInfo.api);
 	}
 
@@ -4148,78 +5548,48 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 
 		output << generateCppApiCheckBegin(methodInfo.api);
 		output << "\t\tmetaData.scriptClass->addInternalCall(\"Internal_" << methodInfo.interopName << "\", (void*)&" <<
-			interopClassName << "::Internal_" << methodInfo.interopName << ");" << std::endl;
+			interopClassName << "::Internal_" << methodInfo.interopName << ");\n";
 		output << generateApiCheckEnd(methodInfo.api);
 	}
 
-	output << std::endl;
+	output << "\n";
 
-	for(auto& eventInfo : classInfo.eventInfos)
+	for(auto& sourceEventInfo : classInfo.eventInfos)
 	{
-		output << generateCppApiCheckBegin(eventInfo.api);
-		output << "\t\t" << eventInfo.sourceName << "Thunk = ";
-		output << "(" << eventInfo.sourceName << "ThunkDef)metaData.scriptClass->getMethodExact(";
-		output << "\"Internal_" << eventInfo.interopName << "\", \"";
-
-		for (auto I = eventInfo.paramInfos.begin(); I != eventInfo.paramInfos.end(); ++I)
-		{
-			const VarInfo& paramInfo = *I;
-			UserTypeInfo paramTypeInfo = getTypeInfo(paramInfo.typeName, paramInfo.flags);
-
-			std::string typeName;
-
-			// Generic types require `X after their name
-			StringRef inputStr(paramTypeInfo.scriptName.data(), paramTypeInfo.scriptName.length());
-			inputStr = inputStr.trim();
-
-			const size_t leftBracketIdx = inputStr.find_first_of('<');
-			const size_t rightBracketIdx = inputStr.find_last_of('>');
-			const size_t numLeftBrackets = inputStr.count('<');
-			const size_t numRightBrackets = inputStr.count('>');
-
-			if (numLeftBrackets > 1 || numRightBrackets > 1)
-			{
-				outs() << "Error: Cannot parse event signature type. Nested generic parameters are not allowed.\n";
-				typeName = paramTypeInfo.scriptName;
-			}
-			else if (leftBracketIdx != StringRef::npos && rightBracketIdx != StringRef::npos)
-			{
-				StringRef templateType = inputStr.substr(0, leftBracketIdx);
-				StringRef templateArgs = inputStr.substr(leftBracketIdx + 1, rightBracketIdx - leftBracketIdx - 1);
-				const size_t numTemplateArgs = templateArgs.count(',') + 1;
-
-				typeName = templateType.str() + "`" + std::to_string(numTemplateArgs) + "<" + templateArgs.str() + ">";
-			}
-			else
-				typeName = paramTypeInfo.scriptName;
-
-			if(typeName == "float")
-				typeName = "single";
+		// Deferred events deliver all their queued fires at once
+		MethodInfo eventInfo = isDeferred(sourceEventInfo.flags) ? getDeferredEventInfo(sourceEventInfo) : 
+			sourceEventInfo;
 
-			std::string csType = getCSVarType(typeName, paramTypeInfo.type, paramInfo.flags, true, true, true, true);
+		output << generateCppApiCheckBegin(eventInfo.api);
 
-			output << csType;
+		// Lazily resolved thunks are only reset here, in case of domain reload
+		if (sLazyRuntimeData)
+			output << "\t\t" << eventInfo.sourceName << "Thunk.store(nullptr, std::memory_order_release);\n";
+		else
+			output << "\t\t" << eventInfo.sourceName << "Thunk = " << generateCppEventThunkLookup(eventInfo) << ";\n";
 
-			if ((I + 1) != eventInfo.paramInfos.end())
-				output << ",";
+		// Cached boxes belong to the previous domain, in case of domain reload
+		for (auto& paramInfo : eventInfo.paramInfos)
+		{
+			if (isCachedEventBoxParam(paramInfo))
+				output << "\t\t" << eventInfo.sourceName << paramInfo.name << "BoxHandle = 0;\n";
 		}
 
-		output << "\")->getThunk();" << std::endl;
 		output << generateApiCheckEnd(eventInfo.api);
 	}
 
-	output << "\t}" << std::endl;
-	output << std::endl;
+	output << "\t}\n";
+	output << "\n";
 
 	// create() or createInstance() methods
 	if ((isClassType(typeInfo.type) && !isModule) || typeInfo.type == ParsedType::Resource)
 	{
-		std::stringstream ctorSignature;
-		std::stringstream ctorParamsInit;
+		CodeWriter ctorSignature(256);
+		CodeWriter ctorParamsInit(256);
 		MethodInfo unusedCtor = findUnusedCtorSignature(classInfo);
 		int numDummyParams = (int)unusedCtor.paramInfos.size();
 
-		ctorParamsInit << "\t\tbool dummy = false;" << std::endl;
+		ctorParamsInit << "\t\tbool dummy = false;\n";
 		ctorParamsInit << "\t\tvoid* ctorParams[" << numDummyParams << "] = { ";
 
 		for (int i = 0; i < numDummyParams; i++)
@@ -4234,40 +5604,49 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 			}
 		}
 
-		ctorParamsInit << " };" << std::endl;
-		ctorParamsInit << std::endl;
+		ctorParamsInit << " };\n";
+		ctorParamsInit << "\n";
 
 		if (isClassType(typeInfo.type))
 		{
-			output << "\tMonoObject* " << interopClassName << "::create(const " << wrappedDataType << "& value)" << std::endl;
-			output << "\t{" << std::endl;
-			output << "\t\tif(value == nullptr) return nullptr; " << std::endl;
-			output << std::endl;
+			output << "\tMonoObject* " << interopClassName << "::create(const " << wrappedDataType << "& value)\n";
+			output << "\t{\n";
+			output << "\t\tif(value == nullptr) return nullptr; \n";
+			output << "\n";
 
 			output << ctorParamsInit.str();
-			output << "\t\tMonoObject* managedInstance = metaData.scriptClass->createInstance(\"" << ctorSignature.str() << "\", ctorParams);" << std::endl;
-			output << "\t\tnew (bs_alloc<" << interopClassName << ">()) " << interopClassName << "(managedInstance, value);" << std::endl;
-			output << "\t\treturn managedInstance;" << std::endl;
+			output << "\t\tMonoObject* managedInstance = metaData.scriptClass->createInstance(\"" << ctorSignature.str() << "\", ctorParams);\n";
+			output << "\t\t" << generateWrapperAllocation(interopClassName, typeInfo.type, "managedInstance, value") << ";\n";
+			output << "\t\treturn managedInstance;\n";
+
+			output << "\t}\n";
 
-			output << "\t}" << std::endl;
+			if (usesPooledWrapperAllocation(typeInfo.type, isModule))
+			{
+				output << "\n";
+				output << "\tvoid " << interopClassName << "::_onManagedInstanceDeleted(bool assemblyRefresh)\n";
+				output << "\t{\n";
+				output << "\t\tbs_pool_delete(this);\n";
+				output << "\t}\n";
+			}
 		}
 		else if (typeInfo.type == ParsedType::Resource)
 		{
-			output << "\t MonoObject*" << interopClassName << "::createInstance()" << std::endl;
-			output << "\t{" << std::endl;
+			output << "\t MonoObject*" << interopClassName << "::createInstance()\n";
+			output << "\t{\n";
 
 			output << ctorParamsInit.str();
-			output << "\t\treturn metaData.scriptClass->createInstance(\"" << ctorSignature.str() << "\", ctorParams);" << std::endl;
+			output << "\t\treturn metaData.scriptClass->createInstance(\"" << ctorSignature.str() << "\", ctorParams);\n";
 
-			output << "\t}" << std::endl;
+			output << "\t}\n";
 		}
 	}
 
 	// Static start-up and shut-down methods, if required
 	if(hasStaticEvents)
 	{
-		output << "\tvoid " << interopClassName << "::startUp()" << std::endl;
-		output << "\t{" << std::endl;
+		output << "\tvoid " << interopClassName << "::startUp()\n";
+		output << "\t{\n";
 
 		for(auto& eventInfo : classInfo.eventInfos)
 		{
@@ -4278,39 +5657,78 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 				if (isStatic)
 				{
 					output << "\t\t" << eventInfo.sourceName << "Conn = ";
-					output << classInfo.name << "::" << eventInfo.sourceName << ".connect(&" << interopClassName << "::" << eventInfo.interopName << ");" << std::endl;
+					output << classInfo.name << "::" << eventInfo.sourceName << ".connect(&" << interopClassName << "::" << eventInfo.interopName << ");\n";
 				}
 				else if (isModule)
 				{
 
 					output << "\t\t" << eventInfo.sourceName << "Conn = ";
-					output << classInfo.name << "::instance()." << eventInfo.sourceName << ".connect(&" << interopClassName << "::" << eventInfo.interopName << ");" << std::endl;
+					output << classInfo.name << "::instance()." << eventInfo.sourceName << ".connect(&" << interopClassName << "::" << eventInfo.interopName << ");\n";
 				}
 			}
 			else
 			{
 				if (isStatic)
-					output << classInfo.name << "::" << eventInfo.sourceName << " = &" << interopClassName << "::" << eventInfo.interopName << ";" << std::endl;
+					output << classInfo.name << "::" << eventInfo.sourceName << " = &" << interopClassName << "::" << eventInfo.interopName << ";\n";
 				else if (isModule)
-					output << classInfo.name << "::instance()." << eventInfo.sourceName << " = &" << interopClassName << "::" << eventInfo.interopName << ";" << std::endl;
+					output << classInfo.name << "::instance()." << eventInfo.sourceName << " = &" << interopClassName << "::" << eventInfo.interopName << ";\n";
 			}
 		}
 
-		output << "\t}" << std::endl;
+		output << "\t}\n";
 
-		output << "\tvoid " << interopClassName << "::shutDown()" << std::endl;
-		output << "\t{" << std::endl;
+		output << "\tvoid " << interopClassName << "::shutDown()\n";
+		output << "\t{\n";
 
 		for(auto& eventInfo : classInfo.eventInfos)
 		{
 			bool isStatic = (eventInfo.flags & (int)MethodFlags::Static) != 0;
 			bool isCallback = (eventInfo.flags & (int)MethodFlags::Callback) != 0;
 			if(!isCallback && (isStatic || isModule))
-				output << "\t\t" << eventInfo.sourceName << "Conn.disconnect();" << std::endl;
+				output << "\t\t" << eventInfo.sourceName << "Conn.disconnect();\n";
+
+			if(isDeferred(eventInfo.flags))
+			{
+				output << "\t\t{\n";
+				output << "\t\t\tLock lock(" << eventInfo.sourceName << "QueueMutex);\n";
+				output << "\t\t\t" << eventInfo.sourceName << "Queue.clear();\n";
+				output << "\t\t}\n";
+			}
+		}
+
+		output << "\t}\n";
+		output << "\n";
+	}
+
+	// Flush methods for deferred events
+	if(hasDeferredEvents(classInfo))
+	{
+		output << "\tvoid " << interopClassName << "::flushEvents()\n";
+		output << "\t{\n";
+
+		for(auto& eventInfo : classInfo.eventInfos)
+		{
+			if(!isDeferred(eventInfo.flags))
+				continue;
+
+			output << generateCppApiCheckBegin(eventInfo.api);
+			output << "\t\t" << eventInfo.sourceName << "Flush();\n";
+			output << generateApiCheckEnd(eventInfo.api);
 		}
 
-		output << "\t}" << std::endl;
-		output << std::endl;
+		output << "\t}\n";
+		output << "\n";
+
+		for(auto& eventInfo : classInfo.eventInfos)
+		{
+			if(!isDeferred(eventInfo.flags))
+				continue;
+
+			output << generateCppApiCheckBegin(eventInfo.api);
+			generateCppEventFlush(eventInfo, interopClassName, isModule, output);
+			output << generateApiCheckEnd(eventInfo.api);
+			output << "\n";
+		}
 	}
 
 	// Event callback method implementations
@@ -4319,12 +5737,12 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 		const MethodInfo& eventInfo = *I;
 
 		output << generateCppApiCheckBegin(eventInfo.api);
-		output << "\t" << generateCppEventCallbackSignature(eventInfo, interopClassName, isModule) << std::endl;
-		output << generateCppEventCallbackBody(eventInfo, isModule);
+		output << "\t" << generateCppEventCallbackSignature(eventInfo, interopClassName, isModule) << "\n";
+		generateCppEventCallbackBody(eventInfo, isModule, output);
 		output << generateApiCheckEnd(eventInfo.api);
 
 		if ((I + 1) != classInfo.eventInfos.end())
-			output << std::endl;
+			output << "\n";
 	}
 
 	// CLR hook method implementations
@@ -4357,12 +5775,12 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 			continue;
 
 		output << generateCppApiCheckBegin(methodInfo.api);
-		output << "\t" << generateCppMethodSignature(methodInfo, interopClassThisPtrType, interopClassName, isModule) << std::endl;
-		output << generateCppMethodBody(classInfo, methodInfo, classInfo.name, interopClassName, typeInfo.type, isModule);
+		output << "\t" << generateCppMethodSignature(methodInfo, interopClassThisPtrType, interopClassName, isModule) << "\n";
+		generateCppMethodBody(classInfo, methodInfo, classInfo.name, interopClassName, typeInfo.type, isModule, output);
 		output << generateApiCheckEnd(methodInfo.api);
 
 		if ((I + 1) != classInfo.methodInfos.end())
-			output << std::endl;
+			output << "\n";
 	}
 
 	// Methods
@@ -4377,12 +5795,12 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 			continue;
 
 		output << generateCppApiCheckBegin(methodInfo.api);
-		output << "\t" << generateCppMethodSignature(methodInfo, interopClassThisPtrType, interopClassName, isModule) << std::endl;
-		output << generateCppMethodBody(classInfo, methodInfo, classInfo.name, interopClassName, typeInfo.type, isModule);
+		output << "\t" << generateCppMethodSignature(methodInfo, interopClassThisPtrType, interopClassName, isModule) << "\n";
+		generateCppMethodBody(classInfo, methodInfo, classInfo.name, interopClassName, typeInfo.type, isModule, output);
 		output << generateApiCheckEnd(methodInfo.api);
 
 		if ((I + 1) != classInfo.methodInfos.end())
-			output << std::endl;
+			output << "\n";
 	}
 
 	// Field wrapper methods
@@ -4410,31 +5828,28 @@ std::string generateCppSourceOutput(const ClassInfo& classInfo, const UserTypeIn
 		assert(getterInfo && setterInfo);
 
 		output << generateCppApiCheckBegin(getterInfo->api);
-		output << "\t" << generateCppMethodSignature(*getterInfo, interopClassThisPtrType, interopClassName, isModule) << std::endl;
-		output << generateCppFieldGetterBody(classInfo, *I, *getterInfo, typeInfo.type, isModule);
+		output << "\t" << generateCppMethodSignature(*getterInfo, interopClassThisPtrType, interopClassName, isModule) << "\n";
+		generateCppFieldGetterBody(classInfo, *I, *getterInfo, typeInfo.type, isModule, output);
 		output << generateApiCheckEnd(getterInfo->api);
 		
-		output << std::endl;
+		output << "\n";
 
 		output << generateCppApiCheckBegin(setterInfo->api);
-		output << "\t" << generateCppMethodSignature(*setterInfo, interopClassThisPtrType, interopClassName, isModule) << std::endl;
-		output << generateCppFieldSetterBody(classInfo, *I, *setterInfo, typeInfo.type, isModule);
+		output << "\t" << generateCppMethodSignature(*setterInfo, interopClassThisPtrType, interopClassName, isModule) << "\n";
+		generateCppFieldSetterBody(classInfo, *I, *setterInfo, typeInfo.type, isModule, output);
 		output << generateApiCheckEnd(setterInfo->api);
 			
 		if ((I + 1) != classInfo.fieldInfos.end())
-			output << std::endl;
+			output << "\n";
 	}
 
 	output << generateApiCheckEnd(classInfo.api);
-
-	return output.str();
 }
 
-std::string generateCppStructHeader(const StructInfo& structInfo)
+void generateCppStructHeader(const StructInfo& structInfo, CodeWriter& output)
 {
 	UserTypeInfo typeInfo = getTypeInfo(structInfo.name, 0);
 
-	std::stringstream output;
 	output << generateCppApiCheckBegin(structInfo.api);
 
 	if(structInfo.requiresInterop)
@@ -4465,19 +5880,19 @@ std::string generateCppStructHeader(const StructInfo& structInfo)
 	std::string interopClassName = getScriptInteropType(structInfo.name);
 	output << interopClassName << " : public " << "ScriptObject<" << interopClassName << ">";
 
-	output << std::endl;
-	output << "\t{" << std::endl;
-	output << "\tpublic:" << std::endl;
+	output << "\n";
+	output << "\t{\n";
+	output << "\tpublic:\n";
 
 	if (!inEditor)
-		output << "\t\tSCRIPT_OBJ(ENGINE_ASSEMBLY, ENGINE_NS, \"" << typeInfo.scriptName << "\")" << std::endl;
+		output << "\t\tSCRIPT_OBJ(ENGINE_ASSEMBLY, ENGINE_NS, \"" << typeInfo.scriptName << "\")\n";
 	else
-		output << "\t\tSCRIPT_OBJ(EDITOR_ASSEMBLY, EDITOR_NS, \"" << typeInfo.scriptName << "\")" << std::endl;
+		output << "\t\tSCRIPT_OBJ(EDITOR_ASSEMBLY, EDITOR_NS, \"" << typeInfo.scriptName << "\")\n";
 
-	output << std::endl;
+	output << "\n";
 
-	output << "\t\tstatic MonoObject* box(const " << structInfo.interopName << "& value);" << std::endl;
-	output << "\t\tstatic " << structInfo.interopName << " unbox(MonoObject* value);" << std::endl;
+	output << "\t\tstatic MonoObject* box(const " << structInfo.interopName << "& value);\n";
+	output << "\t\tstatic " << structInfo.interopName << " unbox(MonoObject* value);\n";
 
 	if(structInfo.requiresInterop)
 	{
@@ -4485,51 +5900,156 @@ std::string generateCppStructHeader(const StructInfo& structInfo)
 		output << "\t\tstatic " << structInfo.interopName << " toInterop(const " << structInfo.name << "& value);\n";
 	}
 
-	output << std::endl;
-	output << "\tprivate:" << std::endl;
+	output << "\n";
+	output << "\tprivate:\n";
 
 	// Constructor
-	output << "\t\t" << interopClassName << "(MonoObject* managedInstance);" << std::endl;
-	output << std::endl;
+	output << "\t\t" << interopClassName << "(MonoObject* managedInstance);\n";
+	output << "\n";
 
-	output << "\t};" << std::endl;
+	output << "\t};\n";
 	output << generateApiCheckEnd(structInfo.api);
+}
 
-	return output.str();
+/** Range of consecutive struct fields that have the same memory layout in the native and the interop struct. */
+struct BlittableFieldRun
+{
+	int first;
+	int count;
+};
+
+/** Checks does the field have the same type in the native and the interop struct, requiring no conversion. */
+bool isBlittableField(const FieldInfo& fieldInfo)
+{
+	if (isArrayOrVector(fieldInfo.flags) || getIsAsyncOp(fieldInfo.flags) || fieldInfo.offset < 0)
+		return false;
+
+	UserTypeInfo typeInfo = getTypeInfo(fieldInfo.typeName, fieldInfo.flags);
+	switch (typeInfo.type)
+	{
+	case ParsedType::Builtin:
+	case ParsedType::Enum:
+		return true;
+	case ParsedType::Struct:
+		return !isComplexStruct(fieldInfo.flags);
+	default:
+		return false;
+	}
+}
+
+/** 
+ * Finds runs of blittable fields that can be copied between the native and the interop struct with a single memcpy.
+ * Fields in a run must be tightly packed in the native struct, and none of them can have a larger alignment than the
+ * first field. This ensures the interop struct, which contains the same fields in the same order, has the same layout
+ * for the run regardless of the fields preceding it.
+ */
+std::vector<BlittableFieldRun> findBlittableFieldRuns(const StructInfo& structInfo)
+{
+	std::vector<BlittableFieldRun> output;
+
+	// Template names cannot be safely passed to offsetof
+	if (structInfo.isTemplateInst)
+		return output;
+
+	int numFields = (int)structInfo.fields.size();
+	for (int i = 0; i < numFields; )
+	{
+		const FieldInfo& firstField = structInfo.fields[i];
+		if (!isBlittableField(firstField))
+		{
+			i++;
+			continue;
+		}
+
+		int end = i + 1;
+		for (; end < numFields; end++)
+		{
+			const FieldInfo& prevField = structInfo.fields[end - 1];
+			const FieldInfo& curField = structInfo.fields[end];
+
+			if (!isBlittableField(curField) || curField.offset != prevField.offset + prevField.size || 
+				curField.alignment > firstField.alignment)
+				break;
+		}
+
+		// A single field is copied just as well with an assignment
+		if (end - i > 1)
+			output.push_back({ i, end - i });
+
+		i = end;
+	}
+
+	return output;
+}
+
+/** 
+ * Outputs a memcpy copying a run of blittable fields from @p src to @p dst. If @p verify is true a static_assert is 
+ * also output, ensuring the fields of the run are tightly packed in both the native and the interop struct.
+ */
+void generateBlittableFieldRunCopy(const StructInfo& structInfo, const BlittableFieldRun& run, const std::string& dst,
+	const std::string& src, bool verify, CodeWriter& output)
+{
+	const FieldInfo& firstField = structInfo.fields[run.first];
+	const FieldInfo& lastField = structInfo.fields[run.first + run.count - 1];
+
+	CodeWriter runSize(256);
+	for (int i = 0; i < run.count; i++)
+	{
+		if (i != 0)
+			runSize << " + ";
+
+		runSize << "sizeof(" << structInfo.name << "::" << structInfo.fields[run.first + i].name << ")";
+	}
+
+	if (verify)
+	{
+		auto getRunSpan = [&firstField, &lastField](const std::string& type)
+		{
+			return "offsetof(" + type + ", " + lastField.name + ") + sizeof(" + type + "::" + lastField.name + 
+				") - offsetof(" + type + ", " + firstField.name + ")";
+		};
+
+		output << "\t\tstatic_assert(" << getRunSpan(structInfo.name) << " == " << runSize.str() << " &&\n";
+		output << "\t\t\t" << getRunSpan(structInfo.interopName) << " == " << runSize.str() << ",\n";
+		output << "\t\t\t\"Fields " << firstField.name << " to " << lastField.name << " of " << structInfo.name << 
+			" must have the same layout in the interop struct.\");\n";
+	}
+
+	output << "\t\tmemcpy(&" << dst << "." << firstField.name << ", &" << src << "." << firstField.name << ", " << 
+		runSize.str() << ");\n";
 }
 
-std::string generateCppStructSource(const StructInfo& structInfo)
+void generateCppStructSource(const StructInfo& structInfo, CodeWriter& output)
 {
 	UserTypeInfo typeInfo = getTypeInfo(structInfo.name, 0);
 	std::string interopClassName = getScriptInteropType(structInfo.name);
 
-	std::stringstream output;
 	output << generateCppApiCheckBegin(structInfo.api);
 
 	// Constructor
-	output << "\t" << interopClassName << "::" << interopClassName << "(MonoObject* managedInstance)" << std::endl;
-	output << "\t\t:ScriptObject(managedInstance)" << std::endl;
-	output << "\t{ }" << std::endl;
-	output << std::endl;
+	output << "\t" << interopClassName << "::" << interopClassName << "(MonoObject* managedInstance)\n";
+	output << "\t\t:ScriptObject(managedInstance)\n";
+	output << "\t{ }\n";
+	output << "\n";
 
 	// Empty initRuntimeData
-	output << "\tvoid " << interopClassName << "::initRuntimeData()" << std::endl;
-	output << "\t{ }" << std::endl;
-	output << std::endl;
+	output << "\tvoid " << interopClassName << "::initRuntimeData()\n";
+	output << "\t{ }\n";
+	output << "\n";
 
 	// Box
-	output << "\tMonoObject*" << interopClassName << "::box(const " << structInfo.interopName << "& value)" << std::endl;
-	output << "\t{" << std::endl;
-	output << "\t\treturn MonoUtil::box(metaData.scriptClass->_getInternalClass(), (void*)&value);" << std::endl;
-	output << "\t}" << std::endl;
-	output << std::endl;
+	output << "\tMonoObject*" << interopClassName << "::box(const " << structInfo.interopName << "& value)\n";
+	output << "\t{\n";
+	output << "\t\treturn MonoUtil::box(metaData.scriptClass->_getInternalClass(), (void*)&value);\n";
+	output << "\t}\n";
+	output << "\n";
 
 	// Unbox
-	output << "\t" << structInfo.interopName << " " << interopClassName << "::unbox(MonoObject* value)" << std::endl;
-	output << "\t{" << std::endl;
-	output << "\t\treturn *(" << structInfo.interopName << "*)MonoUtil::unbox(value);" << std::endl;
-	output << "\t}" << std::endl;
-	output << std::endl;
+	output << "\t" << structInfo.interopName << " " << interopClassName << "::unbox(MonoObject* value)\n";
+	output << "\t{\n";
+	output << "\t\treturn *(" << structInfo.interopName << "*)MonoUtil::unbox(value);\n";
+	output << "\t}\n";
+	output << "\n";
 
 	if(structInfo.requiresInterop)
 	{
@@ -4537,9 +6057,24 @@ std::string generateCppStructSource(const StructInfo& structInfo)
 		output << "\t" << structInfo.name << " " << interopClassName << "::fromInterop(const " << structInfo.interopName << "& value)\n";
 		output << "\t{\n";
 
+		std::vector<BlittableFieldRun> blittableRuns = findBlittableFieldRuns(structInfo);
+
 		output << "\t\t" << structInfo.name << " output;\n";
-		for (auto& fieldInfo : structInfo.fields)
+
+		auto iterRun = blittableRuns.begin();
+		for (int i = 0; i < (int)structInfo.fields.size(); i++)
 		{
+			const FieldInfo& fieldInfo = structInfo.fields[i];
+
+			if (iterRun != blittableRuns.end() && iterRun->first == i)
+			{
+				generateBlittableFieldRunCopy(structInfo, *iterRun, "output", "value", true, output);
+
+				i += iterRun->count - 1;
+				++iterRun;
+				continue;
+			}
+
 			// Arrays can be assigned, so copy them entry by entry
 			if(isArray(fieldInfo.flags))
 			{
@@ -4566,8 +6101,21 @@ std::string generateCppStructSource(const StructInfo& structInfo)
 		output << "\t{\n";
 
 		output << "\t\t" << structInfo.interopName << " output;\n";
-		for(auto& fieldInfo : structInfo.fields)
+
+		iterRun = blittableRuns.begin();
+		for (int i = 0; i < (int)structInfo.fields.size(); i++)
 		{
+			const FieldInfo& fieldInfo = structInfo.fields[i];
+
+			if (iterRun != blittableRuns.end() && iterRun->first == i)
+			{
+				generateBlittableFieldRunCopy(structInfo, *iterRun, "output", "value", false, output);
+
+				i += iterRun->count - 1;
+				++iterRun;
+				continue;
+			}
+
 			std::string argName = generateFieldConvertBlock(fieldInfo.name, fieldInfo, true, output);
 
 			output << "\t\toutput." << fieldInfo.name << " = " << argName << ";\n";
@@ -4579,12 +6127,11 @@ std::string generateCppStructSource(const StructInfo& structInfo)
 	}
 
 	output << generateApiCheckEnd(structInfo.api);
-	return output.str();
 }
 
 std::string generateCSStyleAttributes(const Style& style, const UserTypeInfo& typeInfo, int typeFlags, bool isStruct)
 {
-	std::stringstream output;
+	CodeWriter output;
 	
 	if(((style.flags & (int)StyleFlags::AsLayerMask) != 0) && isInt64(typeInfo))
 		output << "\t\t[LayerMask]\n";
@@ -4657,7 +6204,7 @@ std::string generateCSDefaultValueAssignment(const VarInfo& paramInfo)
 
 std::string generateCSMethodParams(const MethodInfo& methodInfo, bool forInterop)
 {
-	std::stringstream output;
+	CodeWriter output(256);
 	for (auto I = methodInfo.paramInfos.begin(); I != methodInfo.paramInfos.end(); ++I)
 	{
 		const VarInfo& paramInfo = *I;
@@ -4691,7 +6238,7 @@ std::string generateCSMethodParams(const MethodInfo& methodInfo, bool forInterop
 
 std::string generateCSMethodArgs(const MethodInfo& methodInfo, bool forInterop)
 {
-	std::stringstream output;
+	CodeWriter output(256);
 	for (auto I = methodInfo.paramInfos.begin(); I != methodInfo.paramInfos.end(); ++I)
 	{
 		const VarInfo& paramInfo = *I;
@@ -4713,7 +6260,7 @@ std::string generateCSMethodArgs(const MethodInfo& methodInfo, bool forInterop)
 
 std::string generateCSMethodDefaultParamAssignments(const MethodInfo& methodInfo, const std::string& indent)
 {
-	std::stringstream output;
+	CodeWriter output;
 	for (auto I = methodInfo.paramInfos.begin(); I != methodInfo.paramInfos.end(); ++I)
 	{
 		const VarInfo& paramInfo = *I;
@@ -4740,7 +6287,7 @@ std::string generateCSMethodDefaultParamAssignments(const MethodInfo& methodInfo
 
 std::string generateCSEventSignature(const MethodInfo& methodInfo)
 {
-	std::stringstream output;
+	CodeWriter output(256);
 	for (auto I = methodInfo.paramInfos.begin(); I != methodInfo.paramInfos.end(); ++I)
 	{
 		const VarInfo& paramInfo = *I;
@@ -4758,7 +6305,7 @@ std::string generateCSEventSignature(const MethodInfo& methodInfo)
 
 std::string generateCSEventArgs(const MethodInfo& methodInfo)
 {
-	std::stringstream output;
+	CodeWriter output(256);
 
 	for (auto I = methodInfo.paramInfos.begin(); I != methodInfo.paramInfos.end(); ++I)
 	{
@@ -4776,10 +6323,14 @@ std::string generateCSInteropMethodSignature(const MethodInfo& methodInfo, const
 	bool isStatic = (methodInfo.flags & (int)MethodFlags::Static) != 0;
 	bool isCtor = (methodInfo.flags & (int)MethodFlags::Constructor) != 0;
 
-	std::stringstream output;
+	bool isBufferOutput = fillsBuffer(methodInfo.flags);
+
+	CodeWriter output(256);
 
 	bool returnAsParameter = false;
-	if (methodInfo.returnInfo.typeName.empty() || isCtor)
+	if (isBufferOutput)
+		output << "int";
+	else if (methodInfo.returnInfo.typeName.empty() || isCtor)
 		output << "void";
 	else
 	{
@@ -4812,7 +6363,7 @@ std::string generateCSInteropMethodSignature(const MethodInfo& methodInfo, const
 	{
 		output << "IntPtr thisPtr";
 
-		if (methodInfo.paramInfos.size() > 0 || returnAsParameter)
+		if (methodInfo.paramInfos.size() > 0 || returnAsParameter || isBufferOutput)
 			output << ", ";
 	}
 
@@ -4829,29 +6380,40 @@ std::string generateCSInteropMethodSignature(const MethodInfo& methodInfo, const
 		output << "out " << qualifiedType << " __output";
 	}
 
-	output << ")";
-	return output.str();
-}
-
-std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
-{
+	if (isBufferOutput)
+	{
+		UserTypeInfo returnTypeInfo = getTypeInfo(methodInfo.returnInfo.typeName, methodInfo.returnInfo.flags);
+		std::string qualifiedType = getCSVarType(returnTypeInfo.scriptName, returnTypeInfo.type, methodInfo.returnInfo.flags, false, true, false);
+
+		if (methodInfo.paramInfos.size() > 0)
+			output << ", ";
+
+		output << "ref " << qualifiedType << " __buffer";
+	}
+
+	output << ")";
+	return output.str();
+}
+
+void generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo, CodeWriter& output)
+{
 	bool isModule = (input.flags & (int)ClassFlags::IsModule) != 0;
 
-	std::stringstream ctors;
-	std::stringstream properties;
-	std::stringstream events;
-	std::stringstream methods;
-	std::stringstream interops;
+	CodeWriter ctors;
+	CodeWriter properties;
+	CodeWriter events;
+	CodeWriter methods;
+	CodeWriter interops;
 
 	// Private constructor for runtime use
 	MethodInfo pvtCtor = findUnusedCtorSignature(input);
-	ctors << "\t\tprivate " << typeInfo.scriptName << "(" << generateCSMethodParams(pvtCtor, false) << ") { }" << std::endl;
+	ctors << "\t\tprivate " << typeInfo.scriptName << "(" << generateCSMethodParams(pvtCtor, false) << ") { }\n";
 
 	// Parameterless constructor in case anything derives from this class
 	if (!hasParameterlessConstructor(input))
-		ctors << "\t\tprotected " << typeInfo.scriptName << "() { }" << std::endl;
+		ctors << "\t\tprotected " << typeInfo.scriptName << "() { }\n";
 
-	ctors << std::endl;
+	ctors << "\n";
 
 	// Constructors
 	for (auto& entry : input.ctorInfos)
@@ -4860,7 +6422,7 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 		{
 			// Generate interop
 			interops << generateCsApiCheckBegin(entry.api);
-			interops << "\t\t[MethodImpl(MethodImplOptions.InternalCall)]" << std::endl;
+			interops << "\t\t[MethodImpl(MethodImplOptions.InternalCall)]\n";
 			interops << "\t\tprivate static extern void Internal_" << entry.interopName << "(" << typeInfo.scriptName << " managedInstance";
 
 			if (entry.paramInfos.size() > 0)
@@ -4875,7 +6437,7 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 			continue;
 
 		ctors << generateCsApiCheckBegin(entry.api);
-		ctors << generateXMLComments(entry.documentation, "\t\t");
+		generateXMLComments(entry.documentation, "\t\t", ctors);
 
 		if (entry.visibility == CSVisibility::Internal)
 			ctors << "\t\tinternal ";
@@ -4884,18 +6446,18 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 		else
 			ctors << "\t\tpublic ";
 
-		ctors << typeInfo.scriptName << "(" << generateCSMethodParams(entry, false) << ")" << std::endl;
-		ctors << "\t\t{" << std::endl;
+		ctors << typeInfo.scriptName << "(" << generateCSMethodParams(entry, false) << ")\n";
+		ctors << "\t\t{\n";
 		ctors << generateCSMethodDefaultParamAssignments(entry, "\t\t\t");
 		ctors << "\t\t\tInternal_" << entry.interopName << "(this";
 
 		if (entry.paramInfos.size() > 0)
 			ctors << ", " << generateCSMethodArgs(entry, true);
 
-		ctors << ");" << std::endl;
-		ctors << "\t\t}" << std::endl;
+		ctors << ");\n";
+		ctors << "\t\t}\n";
 		ctors << generateApiCheckEnd(entry.api);
-		ctors << std::endl;
+		ctors << "\n";
 	}
 
 	// 'Ref' property & conversion operator to RRef<T>
@@ -4928,9 +6490,9 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 		if (!isCSOnly(entry.flags))
 		{
 			interops << generateCsApiCheckBegin(entry.api);
-			interops << "\t\t[MethodImpl(MethodImplOptions.InternalCall)]" << std::endl;
+			interops << "\t\t[MethodImpl(MethodImplOptions.InternalCall)]\n";
 			interops << "\t\tprivate static extern " << generateCSInteropMethodSignature(entry, typeInfo.scriptName, isModule) << ";";
-			interops << std::endl;
+			interops << "\n";
 			interops << generateApiCheckEnd(entry.api);
 		}
 
@@ -4944,7 +6506,7 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 		if (isConstructor)
 		{
 			ctors << generateCsApiCheckBegin(entry.api);
-			ctors << generateXMLComments(entry.documentation, "\t\t");
+			generateXMLComments(entry.documentation, "\t\t", ctors);
 
 			if (entry.visibility == CSVisibility::Internal)
 				ctors << "\t\tinternal ";
@@ -4953,24 +6515,26 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 			else
 				ctors << "\t\tpublic ";
 
-			ctors << typeInfo.scriptName << "(" << generateCSMethodParams(entry, false) << ")" << std::endl;
-			ctors << "\t\t{" << std::endl;
+			ctors << typeInfo.scriptName << "(" << generateCSMethodParams(entry, false) << ")\n";
+			ctors << "\t\t{\n";
 			ctors << generateCSMethodDefaultParamAssignments(entry, "\t\t\t");
 			ctors << "\t\t\tInternal_" << entry.interopName << "(this";
 
 			if (entry.paramInfos.size() > 0)
 				ctors << ", " << generateCSMethodArgs(entry, true);
 
-			ctors << ");" << std::endl;
-			ctors << "\t\t}" << std::endl;
+			ctors << ");\n";
+			ctors << "\t\t}\n";
 			ctors << generateApiCheckEnd(entry.api);
-			ctors << std::endl;
+			ctors << "\n";
 		}
 		else
 		{
 			bool isProperty = entry.flags & ((int)MethodFlags::PropertyGetter | (int)MethodFlags::PropertySetter);
 			if (!isProperty)
 			{
+				bool isBufferOutput = fillsBuffer(entry.flags);
+
 				UserTypeInfo returnTypeInfo;
 				std::string returnType;
 				if (entry.returnInfo.typeName.empty())
@@ -4981,8 +6545,21 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 					returnType = getCSVarType(returnTypeInfo.scriptName, returnTypeInfo.type, entry.returnInfo.flags, false, true, false);
 				}
 
+				std::string bufferName;
+				std::string methodParams = generateCSMethodParams(entry, false);
+				if (isBufferOutput)
+				{
+					bufferName = getUniqueParamName(entry, "buffer");
+
+					if (!methodParams.empty())
+						methodParams += ", ";
+
+					methodParams += "ref " + returnType + " " + bufferName;
+					returnType = "int";
+				}
+
 				methods << generateCsApiCheckBegin(entry.api);
-				methods << generateXMLComments(entry.documentation, "\t\t");
+				generateXMLComments(entry.documentation, "\t\t", methods);
 
 				if (entry.visibility == CSVisibility::Internal)
 					methods << "\t\tinternal ";
@@ -4994,16 +6571,18 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 				if (isStatic || isModule)
 					methods << "static ";
 
-				methods << returnType << " " << entry.scriptName << "(" << generateCSMethodParams(entry, false) << ")" << std::endl;
-				methods << "\t\t{" << std::endl;
+				methods << returnType << " " << entry.scriptName << "(" << methodParams << ")\n";
+				methods << "\t\t{\n";
 				methods << generateCSMethodDefaultParamAssignments(entry, "\t\t\t");
 
 				bool returnByParam = false;
-				if (!entry.returnInfo.typeName.empty())
+				if (isBufferOutput)
+					methods << "\t\t\treturn Internal_" << entry.interopName << "(";
+				else if (!entry.returnInfo.typeName.empty())
 				{
 					if (!canBeReturned(returnTypeInfo.type, entry.returnInfo.flags))
 					{
-						methods << "\t\t\t" << returnType << " temp;" << std::endl;
+						methods << "\t\t\t" << returnType << " temp;\n";
 						methods << "\t\t\tInternal_" << entry.interopName << "(";
 						returnByParam = true;
 					}
@@ -5017,7 +6596,7 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 				{
 					methods << "mCachedPtr";
 
-					if (entry.paramInfos.size() > 0 || returnByParam)
+					if (entry.paramInfos.size() > 0 || returnByParam || isBufferOutput)
 						methods << ", ";
 				}
 
@@ -5030,15 +6609,22 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 
 					methods << "out temp";
 				}
+				else if (isBufferOutput)
+				{
+					if (entry.paramInfos.size() > 0)
+						methods << ", ";
+
+					methods << "ref " << bufferName;
+				}
 
-				methods << ");" << std::endl;
+				methods << ");\n";
 
 				if (returnByParam)
-					methods << "\t\t\treturn temp;" << std::endl;
+					methods << "\t\t\treturn temp;\n";
 
-				methods << "\t\t}" << std::endl;
+				methods << "\t\t}\n";
 				methods << generateApiCheckEnd(entry.api);
-				methods << std::endl;
+				methods << "\n";
 			}
 		}
 	}
@@ -5050,19 +6636,19 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 		std::string propTypeName = getCSVarType(propTypeInfo.scriptName, propTypeInfo.type, entry.typeFlags, false, true, false);
 
 		properties << generateCsApiCheckBegin(entry.api);
-		properties << generateXMLComments(entry.documentation, "\t\t");
+		generateXMLComments(entry.documentation, "\t\t", properties);
 
 		bool defaultVisible = entry.visibility != CSVisibility::Internal && entry.visibility != CSVisibility::Private &&
 			!entry.setter.empty();
 		if (defaultVisible)
 		{
 			if ((entry.style.flags & (int)StyleFlags::ForceHide) == 0)
-				properties << "\t\t[ShowInInspector]" << std::endl;
+				properties << "\t\t[ShowInInspector]\n";
 		}
 		else
 		{
 			if ((entry.style.flags & (int)StyleFlags::ForceShow) != 0)
-				properties << "\t\t[ShowInInspector]" << std::endl;
+				properties << "\t\t[ShowInInspector]\n";
 		}
 
 		properties << generateCSStyleAttributes(entry.style, propTypeInfo, entry.typeFlags, false);
@@ -5079,8 +6665,8 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 		if (entry.isStatic || isModule)
 			properties << "static ";
 
-		properties << propTypeName << " " << entry.name << std::endl;
-		properties << "\t\t{" << std::endl;
+		properties << propTypeName << " " << entry.name << "\n";
+		properties << "\t\t{\n";
 
 		if (!entry.getter.empty())
 		{
@@ -5091,23 +6677,23 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 				if (!entry.isStatic && !isModule)
 					properties << "mCachedPtr";
 
-				properties << "); }" << std::endl;
+				properties << "); }\n";
 			}
 			else
 			{
-				properties << "\t\t\tget" << std::endl;
-				properties << "\t\t\t{" << std::endl;
-				properties << "\t\t\t\t" << propTypeName << " temp;" << std::endl;
+				properties << "\t\t\tget\n";
+				properties << "\t\t\t{\n";
+				properties << "\t\t\t\t" << propTypeName << " temp;\n";
 
 				properties << "\t\t\t\tInternal_" << entry.getter << "(";
 
 				if (!entry.isStatic && !isModule)
 					properties << "mCachedPtr, ";
 
-				properties << "out temp);" << std::endl;
+				properties << "out temp);\n";
 
-				properties << "\t\t\t\treturn temp;" << std::endl;
-				properties << "\t\t\t}" << std::endl;
+				properties << "\t\t\t\treturn temp;\n";
+				properties << "\t\t\t}\n";
 			}
 		}
 
@@ -5121,12 +6707,12 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 			if(isPlainStruct(propTypeInfo.type, entry.typeFlags))
 				properties << "ref ";
 
-			properties << "value); }" << std::endl;
+			properties << "value); }\n";
 		}
 
-		properties << "\t\t}" << std::endl;
+		properties << "\t\t}\n";
 		properties << generateApiCheckEnd(entry.api);
-		properties << std::endl;
+		properties << "\n";
 	}
 
 	// Events & callbacks
@@ -5137,7 +6723,7 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 		bool isInternal = (entry.flags & (int)MethodFlags::InteropOnly) != 0;
 
 		events << generateCsApiCheckBegin(entry.api);
-		events << generateXMLComments(entry.documentation, "\t\t");
+		generateXMLComments(entry.documentation, "\t\t", events);
 		events << "\t\t";
 
 		if (!isCallback && !isInternal)
@@ -5182,17 +6768,44 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 		if (isStatic || isModule)
 			interops << "static ";
 
-		interops << "void Internal_" << entry.interopName << "(" << generateCSMethodParams(entry, true) << ")" << std::endl;
-		interops << "\t\t{" << std::endl;
-		if (!isCallback && !isInternal)
-			interops << "\t\t\t" << entry.scriptName << "?.Invoke(" << generateCSEventArgs(entry) << ");\n";
+		if (isDeferred(entry.flags))
+		{
+			// All queued fires are delivered at once, with an array entry per fire
+			interops << "void Internal_" << entry.interopName << "(" << 
+				generateCSMethodParams(getDeferredEventInfo(entry), true) << ")\n";
+			interops << "\t\t{\n";
+			interops << "\t\t\tfor (int i = 0; i < count; i++)\n";
+			interops << "\t\t\t\t";
+
+			if (!isCallback && !isInternal)
+				interops << entry.scriptName << "?.Invoke(";
+			else
+				interops << "Callback_" << entry.scriptName << "(";
+
+			for (auto I = entry.paramInfos.begin(); I != entry.paramInfos.end(); ++I)
+			{
+				if (I != entry.paramInfos.begin())
+					interops << ", ";
+
+				interops << I->name << "[i]";
+			}
+
+			interops << ");\n";
+			interops << "\t\t}\n";
+		}
 		else
-			interops << "\t\t\tCallback_" << entry.scriptName << "(" << generateCSEventArgs(entry) << ");\n";
-		interops << "\t\t}" << std::endl;
+		{
+			interops << "void Internal_" << entry.interopName << "(" << generateCSMethodParams(entry, true) << ")\n";
+			interops << "\t\t{\n";
+			if (!isCallback && !isInternal)
+				interops << "\t\t\t" << entry.scriptName << "?.Invoke(" << generateCSEventArgs(entry) << ");\n";
+			else
+				interops << "\t\t\tCallback_" << entry.scriptName << "(" << generateCSEventArgs(entry) << ");\n";
+			interops << "\t\t}\n";
+		}
 		interops << generateApiCheckEnd(entry.api);
 	}
 
-	std::stringstream output;
 	output << generateCsApiCheckBegin(input.api);
 
 	if(!input.module.empty())
@@ -5203,7 +6816,7 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 		output << "\n";
 	}
 
-	output << generateXMLComments(input.documentation, "\t");
+	generateXMLComments(input.documentation, "\t", output);
 
 	// Force non-resource and non-component types to show in inspector, except explicitly hidden
 	if (isClassType(typeInfo.type) || (input.flags & (int)ClassFlags::HideInInspector) == 0)
@@ -5235,16 +6848,16 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 
 	output << "partial class " << typeInfo.scriptName << " : " << baseType;
 
-	output << std::endl;
-	output << "\t{" << std::endl;
+	output << "\n";
+	output << "\t{\n";
 
-	output << ctors.str();
-	output << properties.str();
-	output << events.str();
-	output << methods.str();
-	output << interops.str();
+	output << ctors;
+	output << properties;
+	output << events;
+	output << methods;
+	output << interops;
 
-	output << "\t}" << std::endl;
+	output << "\t}\n";
 
 	if(!input.module.empty())
 	{
@@ -5253,13 +6866,10 @@ std::string generateCSClass(ClassInfo& input, UserTypeInfo& typeInfo)
 	}
 
 	output << generateApiCheckEnd(input.api);
-
-	return output.str();
 }
 
-std::string generateCSStruct(StructInfo& input)
+void generateCSStruct(StructInfo& input, CodeWriter& output)
 {
-	std::stringstream output;
 	output << generateCsApiCheckBegin(input.api);
 
 	if(!input.module.empty())
@@ -5270,7 +6880,7 @@ std::string generateCSStruct(StructInfo& input)
 		output << "\n";
 	}
 
-	output << generateXMLComments(input.documentation, "\t");
+	generateXMLComments(input.documentation, "\t", output);
 
 	output << "\t[StructLayout(LayoutKind.Sequential), SerializeObject]\n";
 
@@ -5286,20 +6896,20 @@ std::string generateCSStruct(StructInfo& input)
 	std::string scriptName = cppToCsTypeMap[input.name].scriptName;
 	output << "partial struct " << scriptName;
 
-	output << std::endl;
-	output << "\t{" << std::endl;
+	output << "\n";
+	output << "\t{\n";
 
 	for (auto& entry : input.ctors)
 	{
 		bool isParameterless = entry.params.size() == 0;
 		if (isParameterless) // Parameterless constructors not supported on C# structs
 		{
-			output << "\t\t/// <summary>Initializes the struct with default values.</summary>" << std::endl;
+			output << "\t\t/// <summary>Initializes the struct with default values.</summary>\n";
 			output << "\t\tpublic static " << scriptName << " Default(";
 		}
 		else
 		{
-			output << generateXMLComments(entry.documentation, "\t\t");
+			generateXMLComments(entry.documentation, "\t\t", output);
 			output << "\t\tpublic " << scriptName << "(";
 		}
 
@@ -5333,13 +6943,13 @@ std::string generateCSStruct(StructInfo& input)
 				output << ", ";
 		}
 
-		output << ")" << std::endl;
-		output << "\t\t{" << std::endl;
+		output << ")\n";
+		output << "\t\t{\n";
 
 		std::string thisPtr;
 		if (isParameterless)
 		{
-			output << "\t\t\t" << scriptName << " value = new " << scriptName << "();" << std::endl;
+			output << "\t\t\t" << scriptName << " value = new " << scriptName << "();\n";
 			thisPtr = "value";
 		}
 		else
@@ -5363,7 +6973,7 @@ std::string generateCSStruct(StructInfo& input)
 			if (iterFind != entry.fieldAssignments.end())
 			{
 				std::string paramName = iterFind->second;
-				output << "\t\t\t" << thisPtr << "." << fieldName << " = " << paramName << ";" << std::endl;
+				output << "\t\t\t" << thisPtr << "." << fieldName << " = " << paramName << ";\n";
 			}
 			else
 			{
@@ -5373,18 +6983,18 @@ std::string generateCSStruct(StructInfo& input)
 				else
 					defaultValue = getDefaultValue(fieldInfo.typeName, fieldInfo.flags, typeInfo);
 
-				output << "\t\t\t" << thisPtr << "." << fieldName << " = " << defaultValue << ";" << std::endl;
+				output << "\t\t\t" << thisPtr << "." << fieldName << " = " << defaultValue << ";\n";
 			}
 		}
 
 		if (isParameterless)
 		{
-			output << std::endl;
-			output << "\t\t\treturn value;" << std::endl;
+			output << "\n";
+			output << "\t\t\treturn value;\n";
 		}
 
-		output << "\t\t}" << std::endl;
-		output << std::endl;
+		output << "\t\t}\n";
+		output << "\n";
 	}
 
 	if(!input.baseClass.empty())
@@ -5442,11 +7052,11 @@ std::string generateCSStruct(StructInfo& input)
 			continue;
 		}
 
-		output << generateXMLComments(fieldInfo.documentation, "\t\t");
+		generateXMLComments(fieldInfo.documentation, "\t\t", output);
 		output << generateCSStyleAttributes(fieldInfo.style, typeInfo, fieldInfo.flags, true);
 
 		if ((fieldInfo.style.flags & (int)StyleFlags::ForceHide) != 0)
-			output << "\t\t[HideInInspector]" << std::endl;
+			output << "\t\t[HideInInspector]\n";
 
 		output << "\t\tpublic ";
 
@@ -5457,10 +7067,10 @@ std::string generateCSStruct(StructInfo& input)
 		output << " ";
 		output << fieldInfo.name;
 
-		output << ";" << std::endl;
+		output << ";\n";
 	}
 
-	output << "\t}" << std::endl;
+	output << "\t}\n";
 
 	if(!input.module.empty())
 	{
@@ -5469,12 +7079,10 @@ std::string generateCSStruct(StructInfo& input)
 	}
 
 	output << generateApiCheckEnd(input.api);
-	return output.str();
 }
 
-std::string generateCSEnum(EnumInfo& input)
+void generateCSEnum(EnumInfo& input, CodeWriter& output)
 {
-	std::stringstream output;
 	output << generateCsApiCheckBegin(input.api);
 
 	if(!input.module.empty())
@@ -5485,7 +7093,7 @@ std::string generateCSEnum(EnumInfo& input)
 		output << "\n";
 	}
 
-	output << generateXMLComments(input.documentation, "\t");
+	generateXMLComments(input.documentation, "\t", output);
 	if (input.visibility == CSVisibility::Internal)
 		output << "\tinternal ";
 	else if (input.visibility == CSVisibility::Public)
@@ -5498,8 +7106,8 @@ std::string generateCSEnum(EnumInfo& input)
 	if (!input.explicitType.empty())
 		output << " : " << input.explicitType;
 
-	output << std::endl;
-	output << "\t{" << std::endl;
+	output << "\n";
+	output << "\t{\n";
 
 	for (auto I = input.entries.begin(); I != input.entries.end(); ++I)
 	{
@@ -5508,14 +7116,14 @@ std::string generateCSEnum(EnumInfo& input)
 
 		const EnumEntryInfo& entryInfo = I->second;
 
-		output << generateXMLComments(entryInfo.documentation, "\t\t");
+		generateXMLComments(entryInfo.documentation, "\t\t", output);
 		output << "\t\t" << entryInfo.scriptName;
 		output << " = ";
 		output << entryInfo.value;
 	}
 	
 	output << "\n";
-	output << "\t}" << std::endl;
+	output << "\t}\n";
 
 	if(!input.module.empty())
 	{
@@ -5524,42 +7132,43 @@ std::string generateCSEnum(EnumInfo& input)
 	}
 
 	output << generateApiCheckEnd(input.api);
-	return output.str();
 }
 
-std::string generateXMLParamInfo(const VarInfo& varInfo, const CommentEntry& methodDoc, const std::string& indent)
+void generateXMLParamInfo(const VarInfo& varInfo, const CommentEntry& methodDoc, const std::string& indent, CodeWriter& output)
 {
-	std::stringstream output;
 	output << indent << "<param name=\"" << escapeXML(varInfo.name) << "\" type=\"" << 
 		escapeXML(getTypeInfo(varInfo.typeName, varInfo.flags).scriptName) << "\">\n";
 
 	auto iterFind = std::find_if(methodDoc.params.begin(), methodDoc.params.end(), 
 		[&varName = varInfo.name](const CommentParamEntry& entry) { return varName == entry.name; });
 	if (iterFind != methodDoc.params.end() && !iterFind->comments.empty())
-		output << indent << "\t<doc>" << generateXMLCommentText(iterFind->comments) << "</doc>\n";
+	{
+		output << indent << "\t<doc>";
+		generateXMLCommentText(iterFind->comments, output);
+		output << "</doc>\n";
+	}
 
 	output << indent << "</param>\n";
-	return output.str();
 }
 
-std::string generateXMLFieldInfo(const FieldInfo& fieldInfo, const std::string& indent)
+void generateXMLFieldInfo(const FieldInfo& fieldInfo, const std::string& indent, CodeWriter& output)
 {
-	std::stringstream output;
 	output << indent << "<field name=\"" << escapeXML(fieldInfo.name) << "\" type=\"" << 
 		escapeXML(getTypeInfo(fieldInfo.typeName, fieldInfo.flags).scriptName) << "\">\n";
 
 	// TODO - Generate inspector visibility
 	if(!fieldInfo.documentation.brief.empty())
-		output << indent << "\t<doc>" << generateXMLCommentText(fieldInfo.documentation.brief) << "</doc>\n";
+	{
+		output << indent << "\t<doc>";
+		generateXMLCommentText(fieldInfo.documentation.brief, output);
+		output << "</doc>\n";
+	}
 
 	output << indent << "</field>\n";
-	return output.str();
 }
 
-std::string generateXMLMethodInfo(const MethodInfo& methodInfo, const std::string& indent, bool ctor)
+void generateXMLMethodInfo(const MethodInfo& methodInfo, const std::string& indent, bool ctor, CodeWriter& output)
 {
-	std::stringstream output;
-
    std::string isStaticStr = "false";
    bool isStatic = (methodInfo.flags & (int)MethodFlags::Static) != 0;
    if(!ctor && isStatic)
@@ -5574,17 +7183,25 @@ std::string generateXMLMethodInfo(const MethodInfo& methodInfo, const std::strin
 		output << indent << "<ctor>\n";
 
 	if(!methodInfo.documentation.brief.empty())
-		output << indent << "\t<doc>" << generateXMLCommentText(methodInfo.documentation.brief) << "</doc>\n";
+	{
+		output << indent << "\t<doc>";
+		generateXMLCommentText(methodInfo.documentation.brief, output);
+		output << "</doc>\n";
+	}
 
 	for(auto& param : methodInfo.paramInfos)
-		output << generateXMLParamInfo(param, methodInfo.documentation, indent + "\t");
+		generateXMLParamInfo(param, methodInfo.documentation, indent + "\t", output);
 
 	if(!ctor && !methodInfo.returnInfo.typeName.empty())
 	{
 		output << indent << "\t<returns type=\"" << escapeXML(getTypeInfo(methodInfo.returnInfo.typeName, methodInfo.returnInfo.flags).scriptName) << "\">\n";
 
 		if (!methodInfo.documentation.returns.empty())
-			output << indent << "\t\t<doc>" << generateXMLCommentText(methodInfo.documentation.returns) << "</doc>\n";
+		{
+			output << indent << "\t\t<doc>";
+			generateXMLCommentText(methodInfo.documentation.returns, output);
+			output << "</doc>\n";
+		}
 
 		output << indent << "\t</returns>\n";
 	}
@@ -5593,29 +7210,28 @@ std::string generateXMLMethodInfo(const MethodInfo& methodInfo, const std::strin
 		output << indent << "</method>\n";
 	else
 		output << indent << "</ctor>\n";
-
-	return output.str();
 }
 
-std::string generateXMLMethodInfo(const SimpleConstructorInfo& methodInfo, const std::string& indent)
+void generateXMLMethodInfo(const SimpleConstructorInfo& methodInfo, const std::string& indent, CodeWriter& output)
 {
-	std::stringstream output;
 	output << indent << "<ctor>\n";
 	if(!methodInfo.documentation.brief.empty())
-		output << indent << "\t<doc>" << generateXMLCommentText(methodInfo.documentation.brief) << "</doc>\n";
+	{
+		output << indent << "\t<doc>";
+		generateXMLCommentText(methodInfo.documentation.brief, output);
+		output << "</doc>\n";
+	}
 
 	for(auto& param : methodInfo.params)
-		output << generateXMLParamInfo(param, methodInfo.documentation, indent + "\t");
+		generateXMLParamInfo(param, methodInfo.documentation, indent + "\t", output);
 
 	output << indent << "</ctor>\n";
-	return output.str();
 }
 
-std::string generateXMLPropertyInfo(const PropertyInfo& propertyInfo, const std::string& indent)
+void generateXMLPropertyInfo(const PropertyInfo& propertyInfo, const std::string& indent, CodeWriter& output)
 {
 	std::string staticStr = propertyInfo.isStatic ? "true" : "false";
 
-	std::stringstream output;
 	output << indent << "<property name=\"" << escapeXML(propertyInfo.name) << "\" type=\"" << 
 		escapeXML(getTypeInfo(propertyInfo.type, propertyInfo.typeFlags).scriptName) << 
 		"\" getter=\"" << escapeXML(propertyInfo.getter) << "\" setter=\"" << escapeXML(propertyInfo.setter) << 
@@ -5623,49 +7239,60 @@ std::string generateXMLPropertyInfo(const PropertyInfo& propertyInfo, const std:
 
 	// TODO - Generate inspector visibility
 	if(!propertyInfo.documentation.brief.empty())
-		output << indent << "\t<doc>" << generateXMLCommentText(propertyInfo.documentation.brief) << "</doc>\n";
+	{
+		output << indent << "\t<doc>";
+		generateXMLCommentText(propertyInfo.documentation.brief, output);
+		output << "</doc>\n";
+	}
 
 	output << indent << "</property>\n";
-	return output.str();
 }
 
-std::string generateXMLEventInfo(const MethodInfo& eventInfo, const std::string& indent)
+void generateXMLEventInfo(const MethodInfo& eventInfo, const std::string& indent, CodeWriter& output)
 {
    bool isStatic = (eventInfo.flags & (int)MethodFlags::Static) != 0;
    std::string staticStr = isStatic ? "true" : "false";
 
-	std::stringstream output;
 	output << indent << "<event native=\"" << escapeXML(eventInfo.sourceName) << "\" script=\"" << escapeXML(eventInfo.scriptName) << 
 		"\" static=\"" << staticStr << "\">\n";
 
 	// TODO - Generate inspector visibility
 	if (!eventInfo.documentation.brief.empty())
-		output << indent << "\t<doc>" << generateXMLCommentText(eventInfo.documentation.brief) << "</doc>\n";
+	{
+		output << indent << "\t<doc>";
+		generateXMLCommentText(eventInfo.documentation.brief, output);
+		output << "</doc>\n";
+	}
 
 	for(auto& param : eventInfo.paramInfos)
-		output << generateXMLParamInfo(param, eventInfo.documentation, indent + "\t");
+		generateXMLParamInfo(param, eventInfo.documentation, indent + "\t", output);
 
 	if(!eventInfo.returnInfo.typeName.empty())
 	{
 		output << indent << "\t<returns type=\"" << escapeXML(getTypeInfo(eventInfo.returnInfo.typeName, eventInfo.returnInfo.flags).scriptName) << "\">\n";
 
 		if (!eventInfo.documentation.returns.empty())
-			output << indent << "\t\t<doc>" << generateXMLCommentText(eventInfo.documentation.returns) << "</doc>\n";
+		{
+			output << indent << "\t\t<doc>";
+			generateXMLCommentText(eventInfo.documentation.returns, output);
+			output << "</doc>\n";
+		}
 
 		output << indent << "\t</returns>\n";
 	}
 
 	output << indent << "</event>\n";
-	return output.str();
 }
 
-std::string generateXMLEnum(EnumInfo& input, const std::string& indent)
+void generateXMLEnum(EnumInfo& input, const std::string& indent, CodeWriter& output)
 {
-	std::stringstream output;
-
 	output << indent << "<enum native=\"" << escapeXML(input.name) << "\" script=\"" << escapeXML(input.scriptName) << "\">\n";
 	if (!input.documentation.brief.empty())
-		output << indent << "\t<doc>" << generateXMLCommentText(input.documentation.brief) << "</doc>\n";
+	{
+		output << indent << "\t<doc>";
+		generateXMLCommentText(input.documentation.brief, output);
+		output << "</doc>\n";
+	}
 	
 	for (auto I = input.entries.begin(); I != input.entries.end(); ++I)
 	{
@@ -5673,49 +7300,55 @@ std::string generateXMLEnum(EnumInfo& input, const std::string& indent)
 
 	   output << indent << "\t<enumentry native=\"" << escapeXML(entryInfo.name) << "\" script=\"" << escapeXML(entryInfo.scriptName) << "\">\n";
 	   if (!entryInfo.documentation.brief.empty())
-		   output << indent << "\t\t<doc>" << generateXMLCommentText(entryInfo.documentation.brief) << "</doc>\n";
+	   {
+		   output << indent << "\t\t<doc>";
+		   generateXMLCommentText(entryInfo.documentation.brief, output);
+		   output << "</doc>\n";
+	   }
 	   output << indent << "\t</enumentry>\n";
 	}
 	
 	output << indent << "</enum>\n";
-	return output.str();
 }
 
-std::string generateXMLStruct(StructInfo& input, const std::string& indent)
+void generateXMLStruct(StructInfo& input, const std::string& indent, CodeWriter& output)
 {
-	std::stringstream output;
-
 	UserTypeInfo& typeInfo = cppToCsTypeMap[input.name];
 
 	output << indent << "<struct native=\"" << escapeXML(input.name) << "\" script=\"" << escapeXML(typeInfo.scriptName) << "\">\n";
 	if (!input.documentation.brief.empty())
-		output << indent << "\t<doc>" << generateXMLCommentText(input.documentation.brief) << "</doc>\n";
+	{
+		output << indent << "\t<doc>";
+		generateXMLCommentText(input.documentation.brief, output);
+		output << "</doc>\n";
+	}
 
 	for (auto& entry : input.ctors)
-		output << generateXMLMethodInfo(entry, indent + "\t");
+		generateXMLMethodInfo(entry, indent + "\t", output);
 
 	for(auto& entry : input.fields)
-	  output << generateXMLFieldInfo(entry, indent + "\t");
+	  generateXMLFieldInfo(entry, indent + "\t", output);
 	
 	output << indent << "</struct>\n";
-	return output.str();
 }
 
-std::string generateXMLClass(ClassInfo& input, bool editor, const std::string& indent)
+void generateXMLClass(ClassInfo& input, bool editor, const std::string& indent, CodeWriter& output)
 {
-	std::stringstream output;
-
 	UserTypeInfo& typeInfo = cppToCsTypeMap[input.name];
 
 	output << indent << "<class native=\"" << escapeXML(input.name) << "\" script=\"" << escapeXML(typeInfo.scriptName) << "\">\n";
 	if (!input.documentation.brief.empty())
-		output << indent << "\t<doc>" << generateXMLCommentText(input.documentation.brief) << "</doc>\n";
+	{
+		output << indent << "\t<doc>";
+		generateXMLCommentText(input.documentation.brief, output);
+		output << "</doc>\n";
+	}
 
 	for (auto& entry : input.ctorInfos)
 	{
 		bool interopOnly = (entry.flags & (int)MethodFlags::InteropOnly) != 0;
 		if(isValidAPI(entry.api, editor) && !interopOnly)
-			output << generateXMLMethodInfo(entry, indent + "\t", true);
+			generateXMLMethodInfo(entry, indent + "\t", true, output);
 	}
 
 	for(auto& entry : input.methodInfos)
@@ -5724,14 +7357,15 @@ std::string generateXMLClass(ClassInfo& input, bool editor, const std::string& i
 		bool isConstructor = (entry.flags & (int)MethodFlags::Constructor) != 0;
 		bool isProperty = entry.flags & ((int)MethodFlags::PropertyGetter | (int)MethodFlags::PropertySetter);
 
-		if(isValidAPI(entry.api, editor) && !interopOnly && !isProperty)
-			output << generateXMLMethodInfo(entry, indent + "\t", isConstructor);
+		// Generated method variants have no native counterpart
+		if(isValidAPI(entry.api, editor) && !interopOnly && !isProperty && !isGeneratedVariant(entry.flags))
+			generateXMLMethodInfo(entry, indent + "\t", isConstructor, output);
 	}
 
    for(auto& entry : input.propertyInfos)
    {
 		if(isValidAPI(entry.api, editor))
-			output << generateXMLPropertyInfo(entry, indent + "\t");
+			generateXMLPropertyInfo(entry, indent + "\t", output);
    }
 
    for(auto& entry : input.eventInfos)
@@ -5740,11 +7374,10 @@ std::string generateXMLClass(ClassInfo& input, bool editor, const std::string& i
 	   bool isInternal = (entry.flags & (int)MethodFlags::InteropOnly) != 0;
 
 	  if(!isCallback && !isInternal)
-		  output << generateXMLEventInfo(entry, indent + "\t");
+		  generateXMLEventInfo(entry, indent + "\t", output);
    }
 	
 	output << indent << "</class>\n";
-	return output.str();
 }
 
 void cleanAndPrepareFolder(const StringRef& folder)
@@ -5759,7 +7392,10 @@ void cleanAndPrepareFolder(const StringRef& folder)
 	sys::fs::create_directories(folder);
 }
 
-std::ofstream createFile(const std::string& filename, StringRef outputFolder)
+/** Contents of generated files, keyed by the full path of the file. */
+typedef std::map<std::string, std::string> GeneratedFiles;
+
+std::string getOutputPath(const std::string& filename, StringRef outputFolder)
 {
 	std::string relativePath = "/" + filename;
 	StringRef filenameRef(relativePath.data(), relativePath.size());
@@ -5767,29 +7403,125 @@ std::ofstream createFile(const std::string& filename, StringRef outputFolder)
 	SmallString<128> filepath = outputFolder;
 	sys::path::append(filepath, filenameRef);
 
-	std::ofstream output;
-	output.open(filepath.str(), std::ios::out);
+	return filepath.str();
+}
 
-	return output;
+/** Records the contents of a generated file. Nothing is written to disk until writeGeneratedFiles() is called. */
+void writeFile(const std::string& filename, StringRef outputFolder, const CodeWriter& contents, GeneratedFiles& files)
+{
+	files[getOutputPath(filename, outputFolder)] = contents.str();
+}
+
+/** 
+ * Checks must the generated file be written without newline translation, because its contents are read by byte offset.
+ */
+bool isBinaryOutput(StringRef path)
+{
+	StringRef filename = sys::path::filename(path);
+	return filename == "info.bin" || filename == "info.xml" || filename == "info.xml.index";
 }
 
-void generateMappingXMLFile(bool editor, const std::string& outputFolder)
+/** Writes all the generated files to disk, using a single write per file. */
+void writeGeneratedFiles(const GeneratedFiles& files)
 {
-	std::stringstream body;
+	for (auto& entry : files)
+	{
+		std::ios::openmode mode = std::ios::out;
+		if (isBinaryOutput(entry.first))
+			mode |= std::ios::binary;
+
+		std::ofstream output;
+		output.open(entry.first, mode);
+		output.write(entry.second.data(), entry.second.size());
+		output.close();
+	}
+}
+
+/** 
+ * Compares the outputs of two generation runs and reports all files that differ between them, along with the first line
+ * that differs. Returns true if the outputs are identical.
+ */
+bool compareGeneratedFiles(const GeneratedFiles& first, const GeneratedFiles& second)
+{
+	bool identical = true;
+	for (auto& entry : first)
+	{
+		auto iterFind = second.find(entry.first);
+		if (iterFind == second.end())
+		{
+			outs() << "Error: File \"" << entry.first << "\" was generated only by the first run.\n";
+			identical = false;
+			continue;
+		}
+
+		const std::string& firstContents = entry.second;
+		const std::string& secondContents = iterFind->second;
+		if (firstContents == secondContents)
+			continue;
+
+		size_t length = std::min(firstContents.size(), secondContents.size());
+		size_t offset = std::mismatch(firstContents.begin(), firstContents.begin() + length, secondContents.begin()).first
+			- firstContents.begin();
+		int line = 1 + (int)std::count(firstContents.begin(), firstContents.begin() + offset, '\n');
+
+		outs() << "Error: Contents of file \"" << entry.first << "\" differ between runs, starting at line " << line << ".\n";
+		identical = false;
+	}
+
+	for (auto& entry : second)
+	{
+		if (first.find(entry.first) == first.end())
+		{
+			outs() << "Error: File \"" << entry.first << "\" was generated only by the second run.\n";
+			identical = false;
+		}
+	}
+
+	return identical;
+}
+
+/** 
+ * Generates info.xml containing the mapping between native and script types, along with their documentation. Also
+ * generates info.xml.index, a sidecar file that maps each type to the byte range of its element in info.xml, one
+ * type per line as tab separated <kind> <native name> <offset> <size>. This allows tools to read information about a 
+ * type without parsing the entire file.
+ */
+void generateMappingXMLFile(bool editor, const std::string& outputFolder, GeneratedFiles& files)
+{
+	CodeWriter output(1024 * 1024);
+	CodeWriter index(64 * 1024);
+
+	auto addIndexEntry = [&output, &index](const char* kind, const std::string& name, size_t start)
+	{
+		index << kind << "\t" << name << "\t" << (unsigned long long)start << "\t" 
+			<< (unsigned long long)(output.size() - start) << "\n";
+	};
+
+	output << "<?xml version='1.0' encoding='UTF-8' standalone='no'?>\n";
+	output << "<entries>\n";
+
 	for (auto& fileInfo : outputFileInfos)
 	{
 		auto& enumInfos = fileInfo.second.enumInfos;
 		for (auto& entry : enumInfos)
 		{
 			if (isValidAPI(entry.api, editor))
-				body << generateXMLEnum(entry, "\t");
+			{
+				size_t start = output.size();
+				generateXMLEnum(entry, "\t", output);
+				addIndexEntry("enum", entry.name, start);
+			}
 		}
 
 		auto& structInfos = fileInfo.second.structInfos;
 		for (auto& entry : structInfos)
 		{
 			if (isValidAPI(entry.api, editor))
-				body << generateXMLStruct(entry, "\t");
+			{
+				size_t start = output.size();
+				generateXMLStruct(entry, "\t", output);
+				addIndexEntry("struct", entry.name, start);
+			}
 		}
 
 
@@ -5797,340 +7529,2327 @@ void generateMappingXMLFile(bool editor, const std::string& outputFolder)
 		for (auto& entry : classInfos)
 		{
 			if (isValidAPI(entry.api, editor))
-				body << generateXMLClass(entry, editor, "\t");
+			{
+				size_t start = output.size();
+				generateXMLClass(entry, editor, "\t", output);
+				addIndexEntry("class", entry.name, start);
+			}
 		}
 	}
 
-	std::ofstream output = createFile("info.xml", outputFolder);
-
-	output << "<?xml version='1.0' encoding='UTF-8' standalone='no'?>\n";
-	output << "<entries>\n";
-	output << body.str();
 	output << "</entries>\n";
-	output.close();
+	writeFile("info.xml", outputFolder, output, files);
+	writeFile("info.xml.index", outputFolder, index, files);
 }
 
-void generateLookupFile(const std::string& tableName, ParsedType type, bool editor, 
-	const std::string& engineOutputFolder, const std::string& editorOutputFolder)
+/**
+ * @name Binary type information
+ *
+ * Compact alternative to info.xml, meant to be memory mapped and read without any parsing. The file starts with a
+ * BinaryInfoHeader, followed by tables of fixed-size records. Each table is referenced from the header by its byte
+ * offset and number of entries. All values are little-endian 32-bit integers or floats, and records reference other
+ * records through table indices (ranges are specified as the first index and the number of entries). Strings are 
+ * referenced through byte offsets into the string table, which contains null-terminated UTF-8 strings, with offset 0 
+ * being the empty string. Documentation strings contain the same text as the <doc> elements in info.xml.
+ * @{
+ */
+
+/** Identifies the format of the file. Changed whenever the layout of any of the records changes. */
+const uint32_t BINARY_INFO_VERSION = 1;
+
+/** Value of index fields that don't reference any record. */
+const uint32_t BINARY_INFO_INVALID_INDEX = 0xFFFFFFFF;
+
+enum BinaryInfoTableType
 {
-	StringRef cppOutputFolder = editor ? editorOutputFolder : engineOutputFolder;
-
-	std::stringstream body;
-	std::stringstream includes;
-	for (auto& fileInfo : outputFileInfos)
-	{
-		auto& classInfos = fileInfo.second.classInfos;
-		if (classInfos.empty())
-			continue;
+	BIT_STRINGS, /**< Count is the size of the string table in bytes. */
+	BIT_CLASSES,
+	BIT_STRUCTS,
+	BIT_ENUMS,
+	BIT_ENUM_ENTRIES,
+	BIT_METHODS,
+	BIT_PARAMS,
+	BIT_PROPERTIES,
+	BIT_FIELDS,
+	BIT_STYLES,
+	BIT_COUNT
+};
 
-		if(fileInfo.second.inEditor != editor)
-			continue;
+enum BinaryMethodFlags
+{
+	BMF_STATIC = 1 << 0,
+	BMF_CONSTRUCTOR = 1 << 1,
+	BMF_EVENT = 1 << 2
+};
 
-		bool hasType = false;
-		for (auto& classInfo : classInfos)
-		{
-			UserTypeInfo& typeInfo = cppToCsTypeMap[classInfo.name];
-			if (typeInfo.type != type)
-				continue;
+struct BinaryInfoTable
+{
+	uint32_t offset;
+	uint32_t count;
+};
 
-			includes << generateCppApiCheckBegin(classInfo.api);
-			includes << "#include \"" << getRelativeTo(typeInfo.declFile, cppOutputFolder) << "\"" << std::endl;
-			includes << generateApiCheckEnd(classInfo.api);
+struct BinaryInfoHeader
+{
+	char magic[4]; /**< Always "BSTI". */
+	uint32_t version;
+	uint32_t fileSize;
+	BinaryInfoTable tables[BIT_COUNT];
+};
 
-			std::string interopClassName = getScriptInteropType(classInfo.name);
-			body << generateCppApiCheckBegin(classInfo.api);
-			body << "\t\tADD_ENTRY(" << classInfo.name << ", " << interopClassName << ")" << std::endl;
-			body << generateApiCheckEnd(classInfo.api);
+struct BinaryClassRecord
+{
+	uint32_t nativeName;
+	uint32_t scriptName;
+	uint32_t doc;
+	uint32_t firstMethod; /**< Constructors, methods and events. */
+	uint32_t numMethods;
+	uint32_t firstProperty;
+	uint32_t numProperties;
+};
 
-			hasType = true;
-		}
+struct BinaryStructRecord
+{
+	uint32_t nativeName;
+	uint32_t scriptName;
+	uint32_t doc;
+	uint32_t firstMethod; /**< Constructors. */
+	uint32_t numMethods;
+	uint32_t firstField;
+	uint32_t numFields;
+};
 
-		if(hasType)
-			includes << "#include \"BsScript" + fileInfo.first + ".generated.h\"" << std::endl;
-	}
+struct BinaryEnumRecord
+{
+	uint32_t nativeName;
+	uint32_t scriptName;
+	uint32_t doc;
+	uint32_t firstEntry;
+	uint32_t numEntries;
+};
 
-	std::string prefix = editor ? "Editor" : "";
-	std::ofstream output = createFile("Bs" + prefix + tableName + "Lookup.generated.h", cppOutputFolder);
+struct BinaryEnumEntryRecord
+{
+	uint32_t nativeName;
+	uint32_t scriptName;
+	uint32_t doc;
+	int32_t value;
+};
 
-	// License/copyright header
-	output << generateFileHeader(editor);
+struct BinaryMethodRecord
+{
+	uint32_t nativeName;
+	uint32_t scriptName;
+	uint32_t doc;
+	uint32_t returnType; /**< Script type name, empty if the method doesn't return a value. */
+	uint32_t returnDoc;
+	uint32_t flags; /**< Combination of BinaryMethodFlags. */
+	uint32_t firstParam;
+	uint32_t numParams;
+};
 
-	output << "#pragma once" << std::endl;
-	output << std::endl;
+struct BinaryParamRecord
+{
+	uint32_t name;
+	uint32_t type;
+	uint32_t doc;
+};
 
-	output << "#include \"Serialization/Bs" << tableName << "Lookup.h\"" << std::endl;
-	output << "#include \"Reflection/BsRTTIType.h\"" << std::endl;
-	output << includes.str();
+struct BinaryPropertyRecord
+{
+	uint32_t name;
+	uint32_t type;
+	uint32_t getter;
+	uint32_t setter;
+	uint32_t doc;
+	uint32_t isStatic;
+	uint32_t style; /**< BINARY_INFO_INVALID_INDEX if no style is specified. */
+};
 
-	output << std::endl;
+struct BinaryFieldRecord
+{
+	uint32_t name;
+	uint32_t type;
+	uint32_t doc;
+	uint32_t style; /**< BINARY_INFO_INVALID_INDEX if no style is specified. */
+};
 
-	output << "namespace " << (editor ? sEditorCppNs : sFrameworkCppNs) << std::endl;
-	output << "{" << std::endl;
-	output << "\tLOOKUP_BEGIN(" << prefix << tableName << ")" << std::endl;
+struct BinaryStyleRecord
+{
+	uint32_t flags; /**< Combination of StyleFlags. */
+	float rangeMin;
+	float rangeMax;
+	float step;
+	int32_t order;
+	uint32_t category;
+};
 
-	output << body.str();
+/** @} */
 
-	output << "\tLOOKUP_END" << std::endl;
-	output << "}" << std::endl;
+/** Builds the tables of the binary type information file. */
+class BinaryInfoWriter
+{
+public:
+	BinaryInfoWriter()
+	{
+		strings.push_back('\0');
+	}
 
-	output << "#undef LOOKUP_BEGIN" << std::endl;
-	output << "#undef ADD_ENTRY" << std::endl;
-	output << "#undef LOOKUP_END" << std::endl;
+	void addEnum(const EnumInfo& input)
+	{
+		BinaryEnumRecord record;
+		record.nativeName = addString(input.name);
+		record.scriptName = addString(input.scriptName);
+		record.doc = addDoc(input.documentation.brief);
+		record.firstEntry = (uint32_t)enumEntries.size();
+		record.numEntries = (uint32_t)input.entries.size();
 
-	output.close();
-}
+		for (auto& entry : input.entries)
+		{
+			BinaryEnumEntryRecord entryRecord;
+			entryRecord.nativeName = addString(entry.second.name);
+			entryRecord.scriptName = addString(entry.second.scriptName);
+			entryRecord.doc = addDoc(entry.second.documentation.brief);
+			entryRecord.value = entry.first;
 
-void generateAll(StringRef cppEngineOutputFolder, StringRef cppEditorOutputFolder, StringRef csEngineOutputFolder, 
-	StringRef csEditorOutputFolder, bool genEditor)
-{
-	postProcessFileInfos();
+			enumEntries.push_back(entryRecord);
+		}
 
-	cleanAndPrepareFolder(cppEngineOutputFolder);
-	cleanAndPrepareFolder(csEngineOutputFolder);
+		enums.push_back(record);
+	}
 
-	if(genEditor)
+	void addStruct(const StructInfo& input)
 	{
-		cleanAndPrepareFolder(cppEditorOutputFolder);
-		cleanAndPrepareFolder(csEditorOutputFolder);
-	}
+		BinaryStructRecord record;
+		record.nativeName = addString(input.name);
+		record.scriptName = addString(getTypeInfo(input.name).scriptName);
+		record.doc = addDoc(input.documentation.brief);
+		record.firstMethod = (uint32_t)methods.size();
+		record.numMethods = (uint32_t)input.ctors.size();
+		record.firstField = (uint32_t)fields.size();
+		record.numFields = (uint32_t)input.fields.size();
 
-	//{
-	//	std::string relativePath = "scriptBindings.timestamp";
-	//	StringRef filenameRef(relativePath.data(), relativePath.size());
+		for (auto& entry : input.ctors)
+			addMethod(std::string(), std::string(), entry.params, entry.documentation, ReturnInfo(), BMF_CONSTRUCTOR);
 
-	//	SmallString<128> filepath = cppOutputFolder;
-	//	sys::path::append(filepath, filenameRef);
+		for (auto& entry : input.fields)
+		{
+			BinaryFieldRecord fieldRecord;
+			fieldRecord.name = addString(entry.name);
+			fieldRecord.type = addString(getTypeInfo(entry.typeName, entry.flags).scriptName);
+			fieldRecord.doc = addDoc(entry.documentation.brief);
+			fieldRecord.style = addStyle(entry.style);
 
-	//	std::ofstream output;
-	//	output.open(filepath.str(), std::ios::out);
+			fields.push_back(fieldRecord);
+		}
 
-	//	std::chrono::milliseconds ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-	//		std::chrono::system_clock::now().time_since_epoch());
-	//	output << std::to_string(ms.count());
-	//	output.close();
-	//}
+		structs.push_back(record);
+	}
 
-	// Generate H
-	for (auto& fileInfo : outputFileInfos)
+	void addClass(const ClassInfo& input, bool editor)
 	{
-		if(fileInfo.second.inEditor && !genEditor)
-			continue;
-
-		std::stringstream body;
-
-		auto& classInfos = fileInfo.second.classInfos;
-		auto& structInfos = fileInfo.second.structInfos;
+		BinaryClassRecord record;
+		record.nativeName = addString(input.name);
+		record.scriptName = addString(getTypeInfo(input.name).scriptName);
+		record.doc = addDoc(input.documentation.brief);
+		record.firstMethod = (uint32_t)methods.size();
+		record.firstProperty = (uint32_t)properties.size();
 
-		if (classInfos.empty() && structInfos.empty())
-			continue;
+		// Note: Filtered in the same way as in generateXMLClass()
+		for (auto& entry : input.ctorInfos)
+		{
+			bool interopOnly = (entry.flags & (int)MethodFlags::InteropOnly) != 0;
+			if (isValidAPI(entry.api, editor) && !interopOnly)
+			{
+				addMethod(std::string(), std::string(), entry.paramInfos, entry.documentation, ReturnInfo(), 
+					BMF_CONSTRUCTOR);
+			}
+		}
 
-		for (auto I = classInfos.begin(); I != classInfos.end(); ++I)
+		for (auto& entry : input.methodInfos)
 		{
-			ClassInfo& classInfo = *I;
-			UserTypeInfo& typeInfo = cppToCsTypeMap[classInfo.name];
+			bool interopOnly = (entry.flags & (int)MethodFlags::InteropOnly) != 0;
+			bool isConstructor = (entry.flags & (int)MethodFlags::Constructor) != 0;
+			bool isProperty = entry.flags & ((int)MethodFlags::PropertyGetter | (int)MethodFlags::PropertySetter);
+			bool isStatic = (entry.flags & (int)MethodFlags::Static) != 0;
 
-			body << generateCppHeaderOutput(classInfo, typeInfo);
+			if (!isValidAPI(entry.api, editor) || interopOnly || isProperty || isGeneratedVariant(entry.flags))
+				continue;
 
-			if ((I + 1) != classInfos.end() || !structInfos.empty())
-				body << std::endl;
+			if (isConstructor)
+			{
+				addMethod(std::string(), std::string(), entry.paramInfos, entry.documentation, ReturnInfo(), 
+					BMF_CONSTRUCTOR);
+			}
+			else
+			{
+				addMethod(entry.sourceName, entry.scriptName, entry.paramInfos, entry.documentation, entry.returnInfo, 
+					isStatic ? BMF_STATIC : 0);
+			}
 		}
 
-		for (auto I = structInfos.begin(); I != structInfos.end(); ++I)
+		for (auto& entry : input.eventInfos)
 		{
-			StructInfo& structInfo = *I;
-			body << generateCppStructHeader(structInfo);
+			bool isCallback = (entry.flags & (int)MethodFlags::Callback) != 0;
+			bool isInternal = (entry.flags & (int)MethodFlags::InteropOnly) != 0;
+			bool isStatic = (entry.flags & (int)MethodFlags::Static) != 0;
 
-			if ((I + 1) != structInfos.end())
-				body << std::endl;
+			if (!isCallback && !isInternal)
+			{
+				addMethod(entry.sourceName, entry.scriptName, entry.paramInfos, entry.documentation, entry.returnInfo, 
+					BMF_EVENT | (isStatic ? BMF_STATIC : 0));
+			}
 		}
 
-		StringRef cppOutputFolder = fileInfo.second.inEditor ? cppEditorOutputFolder : cppEngineOutputFolder;
-		std::ofstream output = createFile("BsScript" + fileInfo.first + ".generated.h", cppOutputFolder);
+		for (auto& entry : input.propertyInfos)
+		{
+			if (!isValidAPI(entry.api, editor))
+				continue;
 
-		// License/copyright header
-		output << generateFileHeader(fileInfo.second.inEditor);
+			BinaryPropertyRecord propertyRecord;
+			propertyRecord.name = addString(entry.name);
+			propertyRecord.type = addString(getTypeInfo(entry.type, entry.typeFlags).scriptName);
+			propertyRecord.getter = addString(entry.getter);
+			propertyRecord.setter = addString(entry.setter);
+			propertyRecord.doc = addDoc(entry.documentation.brief);
+			propertyRecord.isStatic = entry.isStatic ? 1 : 0;
+			propertyRecord.style = addStyle(entry.style);
 
-		output << "#pragma once" << std::endl;
-		output << std::endl;
+			properties.push_back(propertyRecord);
+		}
 
-		// Output includes
-		for (auto& include : fileInfo.second.referencedHeaderIncludes)
-			output << "#include \"" << getRelativeTo(include, cppOutputFolder) << "\"" << std::endl;
+		record.numMethods = (uint32_t)methods.size() - record.firstMethod;
+		record.numProperties = (uint32_t)properties.size() - record.firstProperty;
 
-		output << std::endl;
+		classes.push_back(record);
+	}
 
-		// Output forward declarations
-		for (auto& decl : fileInfo.second.forwardDeclarations)
+	/** Outputs the header followed by all the tables. */
+	void write(CodeWriter& output) const
+	{
+		BinaryInfoHeader header;
+		memcpy(header.magic, "BSTI", sizeof(header.magic));
+		header.version = BINARY_INFO_VERSION;
+
+		uint32_t offset = sizeof(BinaryInfoHeader);
+		auto setTable = [&header, &offset](BinaryInfoTableType type, uint32_t count, uint32_t size)
 		{
-			for (auto& nsEntry : decl.ns)
-				output << "namespace " << nsEntry << " { ";
-			
-			if (decl.templParams.size() > 0)
-			{
+			header.tables[type] = { offset, count };
+
+			// Keep all tables 4-byte aligned
+			offset += (size + 3) & ~3u;
+		};
+
+		setTable(BIT_STRINGS, (uint32_t)strings.size(), (uint32_t)strings.size());
+		setTable(BIT_CLASSES, (uint32_t)classes.size(), getTableSize(classes));
+		setTable(BIT_STRUCTS, (uint32_t)structs.size(), getTableSize(structs));
+		setTable(BIT_ENUMS, (uint32_t)enums.size(), getTableSize(enums));
+		setTable(BIT_ENUM_ENTRIES, (uint32_t)enumEntries.size(), getTableSize(enumEntries));
+		setTable(BIT_METHODS, (uint32_t)methods.size(), getTableSize(methods));
+		setTable(BIT_PARAMS, (uint32_t)params.size(), getTableSize(params));
+		setTable(BIT_PROPERTIES, (uint32_t)properties.size(), getTableSize(properties));
+		setTable(BIT_FIELDS, (uint32_t)fields.size(), getTableSize(fields));
+		setTable(BIT_STYLES, (uint32_t)styles.size(), getTableSize(styles));
+		header.fileSize = offset;
+
+		writeData(&header, sizeof(header), output);
+		writeData(strings.data(), (uint32_t)strings.size(), output);
+		writeData(classes.data(), getTableSize(classes), output);
+		writeData(structs.data(), getTableSize(structs), output);
+		writeData(enums.data(), getTableSize(enums), output);
+		writeData(enumEntries.data(), getTableSize(enumEntries), output);
+		writeData(methods.data(), getTableSize(methods), output);
+		writeData(params.data(), getTableSize(params), output);
+		writeData(properties.data(), getTableSize(properties), output);
+		writeData(fields.data(), getTableSize(fields), output);
+		writeData(styles.data(), getTableSize(styles), output);
+	}
+
+private:
+	template<class T>
+	static uint32_t getTableSize(const std::vector<T>& table)
+	{
+		return (uint32_t)(table.size() * sizeof(T));
+	}
+
+	/** Writes the data followed by padding required to keep the next table 4-byte aligned. */
+	static void writeData(const void* data, uint32_t size, CodeWriter& output)
+	{
+		output << StringRef((const char*)data, size);
+
+		for (uint32_t i = size; (i & 3) != 0; i++)
+			output << '\0';
+	}
+
+	/** Returns the type info for the type with the provided name, without modifying the type map. */
+	static const UserTypeInfo& getTypeInfo(const std::string& name)
+	{
+		static const UserTypeInfo EMPTY_TYPE_INFO = UserTypeInfo();
+
+		auto iterFind = cppToCsTypeMap.find(name);
+		if (iterFind == cppToCsTypeMap.end())
+			return EMPTY_TYPE_INFO;
+
+		return iterFind->second;
+	}
+
+	static UserTypeInfo getTypeInfo(const std::string& name, int flags)
+	{
+		return ::getTypeInfo(name, flags);
+	}
+
+	uint32_t addString(const std::string& value)
+	{
+		if (value.empty())
+			return 0;
+
+		auto iterFind = stringLookup.find(value);
+		if (iterFind != stringLookup.end())
+			return iterFind->second;
+
+		uint32_t offset = (uint32_t)strings.size();
+		strings.insert(strings.end(), value.begin(), value.end());
+		strings.push_back('\0');
+
+		stringLookup[value] = offset;
+		return offset;
+	}
+
+	uint32_t addDoc(const SmallVector<CommentText, 2>& comment)
+	{
+		if (comment.empty())
+			return 0;
+
+		CodeWriter text(256);
+		generateXMLCommentText(comment, text);
+
+		return addString(text.str());
+	}
+
+	uint32_t addStyle(const Style& style)
+	{
+		if (style.flags == 0)
+			return BINARY_INFO_INVALID_INDEX;
+
+		// Note: Values are only valid if their flag is set
+		BinaryStyleRecord record;
+		record.flags = (uint32_t)style.flags;
+		record.rangeMin = (style.flags & (int)StyleFlags::Range) != 0 ? style.rangeMin : 0.0f;
+		record.rangeMax = (style.flags & (int)StyleFlags::Range) != 0 ? style.rangeMax : 0.0f;
+		record.step = (style.flags & (int)StyleFlags::Step) != 0 ? style.step : 0.0f;
+		record.order = (style.flags & (int)StyleFlags::Order) != 0 ? style.order : 0;
+		record.category = (style.flags & (int)StyleFlags::Category) != 0 ? addString(style.category) : 0;
+
+		styles.push_back(record);
+		return (uint32_t)styles.size() - 1;
+	}
+
+	template<class T>
+	void addMethod(const std::string& nativeName, const std::string& scriptName, const std::vector<T>& paramInfos,
+		const CommentEntry& documentation, const ReturnInfo& returnInfo, uint32_t flags)
+	{
+		BinaryMethodRecord record;
+		record.nativeName = addString(nativeName);
+		record.scriptName = addString(scriptName);
+		record.doc = addDoc(documentation.brief);
+		record.returnType = 0;
+		record.returnDoc = 0;
+		record.flags = flags;
+		record.firstParam = (uint32_t)params.size();
+		record.numParams = (uint32_t)paramInfos.size();
+
+		if (!returnInfo.typeName.empty())
+		{
+			record.returnType = addString(getTypeInfo(returnInfo.typeName, returnInfo.flags).scriptName);
+			record.returnDoc = addDoc(documentation.returns);
+		}
+
+		for (auto& entry : paramInfos)
+		{
+			BinaryParamRecord paramRecord;
+			paramRecord.name = addString(entry.name);
+			paramRecord.type = addString(getTypeInfo(entry.typeName, entry.flags).scriptName);
+			paramRecord.doc = 0;
+
+			auto iterFind = std::find_if(documentation.params.begin(), documentation.params.end(), 
+				[&varName = entry.name](const CommentParamEntry& paramEntry) { return varName == paramEntry.name; });
+			if (iterFind != documentation.params.end())
+				paramRecord.doc = addDoc(iterFind->comments);
+
+			params.push_back(paramRecord);
+		}
+
+		methods.push_back(record);
+	}
+
+	std::vector<char> strings;
+	std::unordered_map<std::string, uint32_t> stringLookup;
+
+	std::vector<BinaryClassRecord> classes;
+	std::vector<BinaryStructRecord> structs;
+	std::vector<BinaryEnumRecord> enums;
+	std::vector<BinaryEnumEntryRecord> enumEntries;
+	std::vector<BinaryMethodRecord> methods;
+	std::vector<BinaryParamRecord> params;
+	std::vector<BinaryPropertyRecord> properties;
+	std::vector<BinaryFieldRecord> fields;
+	std::vector<BinaryStyleRecord> styles;
+};
+
+/** 
+ * Generates info.bin, containing the same information as info.xml in a compact binary format that can be memory mapped.
+ * See BinaryInfoHeader for the format description.
+ */
+void generateBinaryInfoFile(bool editor, const std::string& outputFolder, GeneratedFiles& files)
+{
+	BinaryInfoWriter writer;
+	for (auto& fileInfo : outputFileInfos)
+	{
+		for (auto& entry : fileInfo.second.enumInfos)
+		{
+			if (isValidAPI(entry.api, editor))
+				writer.addEnum(entry);
+		}
+
+		for (auto& entry : fileInfo.second.structInfos)
+		{
+			if (isValidAPI(entry.api, editor))
+				writer.addStruct(entry);
+		}
+
+		for (auto& entry : fileInfo.second.classInfos)
+		{
+			if (isValidAPI(entry.api, editor))
+				writer.addClass(entry, editor);
+		}
+	}
+
+	CodeWriter output(1024 * 1024);
+	writer.write(output);
+
+	writeFile("info.bin", outputFolder, output, files);
+}
+
+/** 
+ * Hash used by the generated perfect hash tables. Must match the hash() function output by 
+ * generatePerfectHashTable(). 
+ */
+uint32_t getPerfectHash(StringRef name, uint32_t seed)
+{
+	uint32_t value = 2166136261u ^ seed;
+	for (char entry : name)
+	{
+		value ^= (uint8_t)entry;
+		value *= 16777619u;
+	}
+
+	value ^= value >> 16;
+	value *= 0x85EBCA6Bu;
+	value ^= value >> 13;
+	value *= 0xC2B2AE35u;
+	value ^= value >> 16;
+
+	return value;
+}
+
+/** 
+ * Attempts to build a perfect hash table with the provided number of buckets and slots (both powers of two). See
+ * buildPerfectHashTable(). Returns false if no seed could be found for some bucket within @p maxSeeds attempts.
+ */
+bool tryBuildPerfectHashTable(ArrayRef<std::string> names, uint32_t numBuckets, uint32_t numSlots, uint32_t maxSeeds,
+	std::vector<uint32_t>& displacements, std::vector<int>& slots)
+{
+	// Note: Duplicate names would never map to different slots, only the first one is added
+	std::unordered_set<std::string> addedNames;
+	std::vector<std::vector<int>> buckets(numBuckets);
+	for (int i = 0; i < (int)names.size(); i++)
+	{
+		if (addedNames.insert(names[i]).second)
+			buckets[getPerfectHash(names[i], 0) & (numBuckets - 1)].push_back(i);
+	}
+
+	// Place largest buckets first, while most of the slots are still free
+	std::vector<int> bucketOrder(numBuckets);
+	for (int i = 0; i < (int)numBuckets; i++)
+		bucketOrder[i] = i;
+
+	std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&buckets](int a, int b)
+	{
+		return buckets[a].size() > buckets[b].size();
+	});
+
+	displacements.assign(numBuckets, 0);
+	slots.assign(numSlots, -1);
+
+	SmallVector<uint32_t, 8> bucketSlots;
+	for (auto& bucketIdx : bucketOrder)
+	{
+		auto& bucket = buckets[bucketIdx];
+		if (bucket.empty())
+			break;
+
+		bool found = false;
+		for (uint32_t seed = 1; seed <= maxSeeds; seed++)
+		{
+			bucketSlots.clear();
+			for (auto& entry : bucket)
+			{
+				uint32_t slot = getPerfectHash(names[entry], seed) & (numSlots - 1);
+				if (slots[slot] != -1 || std::find(bucketSlots.begin(), bucketSlots.end(), slot) != bucketSlots.end())
+					break;
+
+				bucketSlots.push_back(slot);
+			}
+
+			if (bucketSlots.size() != bucket.size())
+				continue;
+
+			for (int i = 0; i < (int)bucket.size(); i++)
+				slots[bucketSlots[i]] = bucket[i];
+
+			displacements[bucketIdx] = seed;
+			found = true;
+			break;
+		}
+
+		if (!found)
+			return false;
+	}
+
+	return true;
+}
+
+/** 
+ * Builds a perfect hash table over the provided names, using the hash and displace method. Names are first distributed
+ * into buckets, after which a seed (displacement) is found for each bucket so all names in the bucket map to unused 
+ * slots. Lookup requires computing two hashes and probing a single slot. Slots contain indices into @p names, or -1 if
+ * unused. If a bucket cannot be placed within a bounded number of seeds the table is rebuilt with twice the slots.
+ * Returns false if no table could be built, in which case the output must not be used.
+ */
+bool buildPerfectHashTable(ArrayRef<std::string> names, std::vector<uint32_t>& displacements, std::vector<int>& slots)
+{
+	static constexpr uint32_t MAX_SEEDS_PER_BUCKET = 1 << 16;
+
+	uint32_t numBuckets = (uint32_t)NextPowerOf2(std::max((uint32_t)names.size() / 2, 1u) - 1);
+	uint32_t numSlots = (uint32_t)NextPowerOf2(std::max((uint32_t)names.size() * 2, 1u) - 1);
+
+	while (!tryBuildPerfectHashTable(names, numBuckets, numSlots, MAX_SEEDS_PER_BUCKET, displacements, slots))
+	{
+		// Each slot doubling halves the load factor, so this terminates long before running out of address space
+		if (numSlots >= (1u << 30))
+		{
+			outs() << "Error: Unable to build a perfect hash table over " << (uint32_t)names.size() << " names.\n";
+			return false;
+		}
+
+		numSlots *= 2;
+	}
+
+	return true;
+}
+
+/** 
+ * Generates constexpr tables of a perfect hash over the provided names, mapping each name to its index. Tables are
+ * output at the provided indentation, within a namespace that is expected to contain the hash() function. Returns false
+ * if the hash table could not be built.
+ */
+bool generatePerfectHashTable(ArrayRef<std::string> names, const std::string& indent, CodeWriter& output)
+{
+	std::vector<uint32_t> displacements;
+	std::vector<int> slots;
+	if (!buildPerfectHashTable(names, displacements, slots))
+		return false;
+
+	output << indent << "constexpr const char* NAMES[] = { ";
+	if (names.empty())
+		output << "nullptr";
+
+	for (int i = 0; i < (int)names.size(); i++)
+	{
+		if (i != 0)
+			output << ", ";
+
+		output << "\"" << names[i] << "\"";
+	}
+	output << " };\n";
+
+	output << indent << "constexpr UINT32 DISPLACEMENTS[] = { ";
+	for (int i = 0; i < (int)displacements.size(); i++)
+	{
+		if (i != 0)
+			output << ", ";
+
+		output << displacements[i];
+	}
+	output << " };\n";
+
+	output << indent << "constexpr INT32 SLOTS[] = { ";
+	for (int i = 0; i < (int)slots.size(); i++)
+	{
+		if (i != 0)
+			output << ", ";
+
+		output << slots[i];
+	}
+	output << " };\n";
+
+	return true;
+}
+
+/** 
+ * Generates a header that maps the names of all classes of the provided type to their interop classes, using a perfect
+ * hash lookup. Returns false if the lookup tables could not be generated, in which case no file is written.
+ */
+bool generateLookupFile(const std::string& tableName, ParsedType type, bool editor, 
+	const std::string& engineOutputFolder, const std::string& editorOutputFolder, GeneratedFiles& files)
+{
+	StringRef cppOutputFolder = editor ? editorOutputFolder : engineOutputFolder;
+
+	CodeWriter body;
+	CodeWriter includes;
+
+	// Names of all entries, in the order they are added, when compiling with and without BS_IS_BANSHEE3D
+	std::vector<std::string> bsfNames;
+	std::vector<std::string> b3dNames;
+	for (auto& fileInfo : outputFileInfos)
+	{
+		auto& classInfos = fileInfo.second.classInfos;
+		if (classInfos.empty())
+			continue;
+
+		if(fileInfo.second.inEditor != editor)
+			continue;
+
+		bool hasType = false;
+		for (auto& classInfo : classInfos)
+		{
+			UserTypeInfo& typeInfo = cppToCsTypeMap[classInfo.name];
+			if (typeInfo.type != type)
+				continue;
+
+			includes << generateCppApiCheckBegin(classInfo.api);
+			includes << "#include \"" << getRelativeTo(typeInfo.declFile, cppOutputFolder) << "\"\n";
+			includes << generateApiCheckEnd(classInfo.api);
+
+			std::string interopClassName = getScriptInteropType(classInfo.name);
+			body << generateCppApiCheckBegin(classInfo.api);
+			body << "\t\tADD_ENTRY(" << classInfo.name << ", " << interopClassName << ")\n";
+			body << generateApiCheckEnd(classInfo.api);
+
+			if (classInfo.api != ApiFlags::B3D)
+				bsfNames.push_back(classInfo.name);
+
+			if (classInfo.api != ApiFlags::BSF)
+				b3dNames.push_back(classInfo.name);
+
+			hasType = true;
+		}
+
+		if(hasType)
+			includes << "#include \"BsScript" + fileInfo.first + ".generated.h\"\n";
+	}
+
+	std::string prefix = editor ? "Editor" : "";
+	CodeWriter output(body.size() + includes.size() + 4096);
+
+	// License/copyright header
+	output << generateFileHeader(editor);
+
+	output << "#pragma once\n";
+	output << "\n";
+
+	output << "#include \"Serialization/Bs" << tableName << "Lookup.h\"\n";
+	output << "#include \"Reflection/BsRTTIType.h\"\n";
+	output << includes;
+
+	output << "\n";
+
+	output << "namespace " << (editor ? sEditorCppNs : sFrameworkCppNs) << "\n";
+	output << "{\n";
+	output << "\tLOOKUP_BEGIN(" << prefix << tableName << ")\n";
+
+	output << body;
+
+	output << "\tLOOKUP_END\n";
+	output << "\n";
+
+	// Perfect hash over type names, allowing the entry for a type to be found without searching the list
+	output << "\t/** Maps native type names to the index of their entry in the lookup above, in the order they were added. */\n";
+	output << "\tnamespace " << prefix << tableName << "Index\n";
+	output << "\t{\n";
+	output << "\t\tconstexpr UINT32 hash(const char* name, UINT32 seed)\n";
+	output << "\t\t{\n";
+	output << "\t\t\tUINT32 value = 2166136261u ^ seed;\n";
+	output << "\t\t\tfor (; *name != '\\0'; ++name)\n";
+	output << "\t\t\t{\n";
+	output << "\t\t\t\tvalue ^= (UINT8)*name;\n";
+	output << "\t\t\t\tvalue *= 16777619u;\n";
+	output << "\t\t\t}\n";
+	output << "\n";
+	output << "\t\t\tvalue ^= value >> 16;\n";
+	output << "\t\t\tvalue *= 0x85EBCA6Bu;\n";
+	output << "\t\t\tvalue ^= value >> 13;\n";
+	output << "\t\t\tvalue *= 0xC2B2AE35u;\n";
+	output << "\t\t\tvalue ^= value >> 16;\n";
+	output << "\t\t\treturn value;\n";
+	output << "\t\t}\n";
+	output << "\n";
+	output << "\t\tconstexpr bool equals(const char* a, const char* b)\n";
+	output << "\t\t{\n";
+	output << "\t\t\tfor (; *a != '\\0' && *a == *b; ++a, ++b) { }\n";
+	output << "\t\t\treturn *a == *b;\n";
+	output << "\t\t}\n";
+	output << "\n";
+
+	bool builtTables;
+	if (bsfNames == b3dNames)
+		builtTables = generatePerfectHashTable(bsfNames, "\t\t", output);
+	else
+	{
+		output << "#if BS_IS_BANSHEE3D\n";
+		builtTables = generatePerfectHashTable(b3dNames, "\t\t", output);
+		output << "#else\n";
+		builtTables = generatePerfectHashTable(bsfNames, "\t\t", output) && builtTables;
+		output << "#endif\n";
+	}
+
+	if (!builtTables)
+	{
+		outs() << "Error: Unable to generate the " << tableName << " lookup.\n";
+		return false;
+	}
+
+	output << "\n";
+	output << "\t\t/** Returns the index of the entry for the type with the provided name, or -1 if there is no such entry. */\n";
+	output << "\t\tconstexpr INT32 find(const char* name)\n";
+	output << "\t\t{\n";
+	output << "\t\t\tconstexpr UINT32 bucketMask = sizeof(DISPLACEMENTS) / sizeof(DISPLACEMENTS[0]) - 1;\n";
+	output << "\t\t\tconstexpr UINT32 slotMask = sizeof(SLOTS) / sizeof(SLOTS[0]) - 1;\n";
+	output << "\n";
+	output << "\t\t\tconst INT32 idx = SLOTS[hash(name, DISPLACEMENTS[hash(name, 0) & bucketMask]) & slotMask];\n";
+	output << "\t\t\treturn (idx != -1 && equals(NAMES[idx], name)) ? idx : -1;\n";
+	output << "\t\t}\n";
+	output << "\t}\n";
+	output << "}\n";
+
+	output << "#undef LOOKUP_BEGIN\n";
+	output << "#undef ADD_ENTRY\n";
+	output << "#undef LOOKUP_END\n";
+
+	writeFile("Bs" + prefix + tableName + "Lookup.generated.h", cppOutputFolder, output, files);
+	return true;
+}
+
+/** Class or struct whose C++ source is emitted as part of a source file bundling multiple exported files. */
+struct SourceUnit
+{
+	const OutputFileEntry* file;
+	const ClassInfo* classInfo;
+	const StructInfo* structInfo;
+	int cost;
+};
+
+/** Hash that is identical across runs and platforms (FNV-1a), used for assigning units to shards. */
+uint32_t getStableHash(StringRef value)
+{
+	uint32_t hash = 2166136261u;
+	for (char entry : value)
+	{
+		hash ^= (uint8_t)entry;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+/** 
+ * Estimates the relative cost of compiling the generated C++ source of a class, based on the number of emitted methods.
+ * @p includeWeight is the share of the includes of the originating file attributed to the class.
+ */
+int estimateCompileCost(const ClassInfo& classInfo, int includeWeight)
+{
+	// Events emit both a callback and a thunk, while fields are emitted as getter/setter methods
+	int numMethods = (int)classInfo.methodInfos.size() + (int)classInfo.ctorInfos.size() + 
+		(int)classInfo.eventInfos.size() * 2;
+
+	return 4 + numMethods * 4 + includeWeight;
+}
+
+/** Estimates the relative cost of compiling the generated C++ source of a struct, based on the number of fields. */
+int estimateCompileCost(const StructInfo& structInfo, int includeWeight)
+{
+	// Box, unbox and interop conversion methods, whose size depends on the number of fields
+	return 4 + (int)structInfo.fields.size() + includeWeight;
+}
+
+/**
+ * Distributes the units over @p numShards shards so that each shard ends up with a similar estimated compile cost.
+ * Every unit ranks the shards by hashing its name together with the shard index (rendezvous hashing), and is placed
+ * into its highest ranked shard that still has room. Adding, removing or modifying a unit therefore only moves a small
+ * number of other units to a different shard, keeping incremental builds incremental.
+ */
+std::vector<int> assignSourceShards(ArrayRef<SourceUnit> units, int numShards)
+{
+	int totalCost = 0;
+	int maxCost = 0;
+	for (auto& entry : units)
+	{
+		totalCost += entry.cost;
+		maxCost = std::max(maxCost, entry.cost);
+	}
+
+	// Allow some imbalance so units don't need to move whenever the costs change slightly
+	int maxShardCost = std::max((totalCost + totalCost / 10) / numShards + 1, maxCost);
+
+	// Place units in the order of their names, so the order is independent of the order of files
+	std::vector<int> order(units.size());
+	for (int i = 0; i < (int)units.size(); i++)
+		order[i] = i;
+
+	auto getName = [](const SourceUnit& unit) -> const std::string&
+	{
+		return unit.classInfo != nullptr ? unit.classInfo->name : unit.structInfo->name;
+	};
+
+	std::stable_sort(order.begin(), order.end(), [&units, &getName](int a, int b)
+	{
+		return getName(units[a]) < getName(units[b]);
+	});
+
+	std::vector<int> shardCosts(numShards, 0);
+	std::vector<int> output(units.size(), 0);
+	std::vector<std::pair<uint32_t, int>> ranking(numShards);
+	for (auto& idx : order)
+	{
+		const SourceUnit& unit = units[idx];
+		uint32_t nameHash = getStableHash(getName(unit));
+
+		for (int i = 0; i < numShards; i++)
+		{
+			// Mix the shard index into the hash (MurmurHash3 finalizer)
+			uint32_t score = nameHash ^ ((uint32_t)i * 0x9E3779B9u);
+			score ^= score >> 16;
+			score *= 0x85EBCA6Bu;
+			score ^= score >> 13;
+			score *= 0xC2B2AE35u;
+			score ^= score >> 16;
+
+			ranking[i] = std::make_pair(score, i);
+		}
+
+		std::sort(ranking.begin(), ranking.end(), std::greater<std::pair<uint32_t, int>>());
+
+		int shardIdx = -1;
+		for (auto& entry : ranking)
+		{
+			if (shardCosts[entry.second] + unit.cost <= maxShardCost)
+			{
+				shardIdx = entry.second;
+				break;
+			}
+		}
+
+		// All shards are full, fall back to the least loaded one
+		if (shardIdx == -1)
+			shardIdx = (int)(std::min_element(shardCosts.begin(), shardCosts.end()) - shardCosts.begin());
+
+		shardCosts[shardIdx] += unit.cost;
+		output[idx] = shardIdx;
+	}
+
+	return output;
+}
+
+/** 
+ * Generates a C++ source containing the code of all the provided units. Includes required by all the units are output
+ * first, followed by the units in the provided order.
+ */
+void generateSourceBundle(bool editor, StringRef cppOutputFolder, ArrayRef<SourceUnit> units, CodeWriter& output)
+{
+	// Includes of all files contributing to the bundle
+	std::vector<std::string> includes;
+	for (auto& entry : units)
+	{
+		auto& fileIncludes = entry.file->second.referencedSourceIncludes;
+		includes.insert(includes.end(), fileIncludes.begin(), fileIncludes.end());
+	}
+
+	removeRedundantIncludes(includes, {});
+
+	// License/copyright header
+	output << generateFileHeader(editor);
+
+	for (auto& include : includes)
+		output << "#include \"" << getRelativeTo(include, cppOutputFolder) << "\"\n";
+
+	output << "\n";
+
+	// Note: Generated sources only define members of the generated classes and no file-local symbols, so the code of 
+	// multiple files can share a translation unit without renaming anything
+	output << "namespace " << (editor ? sEditorCppNs : sFrameworkCppNs) << "\n";
+	output << "{\n";
+
+	for (auto I = units.begin(); I != units.end(); ++I)
+	{
+		if (I != units.begin())
+			output << "\n";
+
+		if (I->classInfo != nullptr)
+		{
+			const ClassInfo& classInfo = *I->classInfo;
+			UserTypeInfo& typeInfo = cppToCsTypeMap[classInfo.name];
+
+			generateCppSourceOutput(classInfo, typeInfo, output);
+		}
+		else
+			generateCppStructSource(*I->structInfo, output);
+	}
+
+	output << "}\n";
+}
+
+/** 
+ * Generates C++ sources for all engine or editor files, regrouped into a fixed number of shards of similar estimated 
+ * compile cost, instead of one source per exported file. Headers are still generated per file.
+ */
+void generateSourceShards(bool editor, StringRef cppOutputFolder, CodeWriter& output, GeneratedFiles& files)
+{
+	std::vector<SourceUnit> units;
+	for (auto& fileInfo : outputFileInfos)
+	{
+		if (fileInfo.second.inEditor != editor)
+			continue;
+
+		auto& classInfos = fileInfo.second.classInfos;
+		auto& structInfos = fileInfo.second.structInfos;
+
+		int numUnits = (int)(classInfos.size() + structInfos.size());
+		if (numUnits == 0)
+			continue;
+
+		int numIncludes = (int)fileInfo.second.referencedSourceIncludes.size();
+		int includeWeight = (numIncludes + numUnits - 1) / numUnits;
+
+		for (auto& classInfo : classInfos)
+			units.push_back({ &fileInfo, &classInfo, nullptr, estimateCompileCost(classInfo, includeWeight) });
+
+		for (auto& structInfo : structInfos)
+			units.push_back({ &fileInfo, nullptr, &structInfo, estimateCompileCost(structInfo, includeWeight) });
+	}
+
+	int numShards = sNumSourceShards;
+	std::vector<int> shardIndices = assignSourceShards(units, numShards);
+
+	std::string prefix = editor ? "Editor" : "";
+	for (int i = 0; i < numShards; i++)
+	{
+		std::vector<SourceUnit> shardUnits;
+		for (int j = 0; j < (int)units.size(); j++)
+		{
+			if (shardIndices[j] == i)
+				shardUnits.push_back(units[j]);
+		}
+
+		// Note: Empty shards are still generated, so the list of files the build needs to compile stays the same
+		output.clear();
+		generateSourceBundle(editor, cppOutputFolder, shardUnits, output);
+		writeFile("BsScript" + prefix + "Shard" + std::to_string(i) + ".generated.cpp", cppOutputFolder, output, files);
+	}
+}
+
+/** Returns the module the types exported in the file belong to, or an empty string if the module is not specified. */
+StringRef getFileModule(const FileInfo& fileInfo)
+{
+	for (auto& entry : fileInfo.classInfos)
+	{
+		if (!entry.module.empty())
+			return entry.module;
+	}
+
+	for (auto& entry : fileInfo.structInfos)
+	{
+		if (!entry.module.empty())
+			return entry.module;
+	}
+
+	for (auto& entry : fileInfo.enumInfos)
+	{
+		if (!entry.module.empty())
+			return entry.module;
+	}
+
+	return StringRef();
+}
+
+/** Checks if the C++ source of the file should be bundled in a unity source, instead of being generated on its own. */
+bool isUnityBuildFile(const FileInfo& fileInfo)
+{
+	if (sUnityBuildSize <= 0)
+		return false;
+
+	StringRef module = getFileModule(fileInfo);
+	return std::find(sUnityExcludedModules.begin(), sUnityExcludedModules.end(), module) == sUnityExcludedModules.end();
+}
+
+/** 
+ * Generates unity C++ sources for all engine or editor files, each containing the code of up to sUnityBuildSize 
+ * exported files. Files belonging to modules excluded from the unity build are skipped.
+ */
+void generateUnitySources(bool editor, StringRef cppOutputFolder, CodeWriter& output, GeneratedFiles& files)
+{
+	std::string prefix = editor ? "Editor" : "";
+	std::vector<SourceUnit> units;
+	int numFiles = 0;
+	int numUnitySources = 0;
+
+	auto writeUnitySource = [&]()
+	{
+		output.clear();
+		generateSourceBundle(editor, cppOutputFolder, units, output);
+		writeFile("BsScript" + prefix + "Unity" + std::to_string(numUnitySources) + ".generated.cpp", cppOutputFolder, 
+			output, files);
+
+		units.clear();
+		numFiles = 0;
+		numUnitySources++;
+	};
+
+	for (auto& fileInfo : outputFileInfos)
+	{
+		if (fileInfo.second.inEditor != editor || !isUnityBuildFile(fileInfo.second))
+			continue;
+
+		auto& classInfos = fileInfo.second.classInfos;
+		auto& structInfos = fileInfo.second.structInfos;
+
+		if (classInfos.empty() && structInfos.empty())
+			continue;
+
+		for (auto& classInfo : classInfos)
+			units.push_back({ &fileInfo, &classInfo, nullptr, 0 });
+
+		for (auto& structInfo : structInfos)
+			units.push_back({ &fileInfo, nullptr, &structInfo, 0 });
+
+		numFiles++;
+		if (numFiles == sUnityBuildSize)
+			writeUnitySource();
+	}
+
+	if (!units.empty())
+		writeUnitySource();
+}
+
+/** 
+ * Generates a header including the headers most frequently used by the generated engine or editor sources, meant to be 
+ * used as a precompiled header when compiling them.
+ */
+void generatePrecompiledHeader(bool editor, StringRef cppOutputFolder, GeneratedFiles& files)
+{
+	// Headers included by at least this portion of generated sources are added to the precompiled header
+	const float MIN_INCLUDE_FREQUENCY = 0.5f;
+
+	struct IncludeFrequency
+	{
+		int count;
+		int firstUse;
+	};
+
+	std::unordered_map<std::string, IncludeFrequency> frequencies;
+	std::vector<std::string> orderedIncludes;
+	int numSources = 0;
+	for (auto& fileInfo : outputFileInfos)
+	{
+		if (fileInfo.second.inEditor != editor)
+			continue;
+
+		if (fileInfo.second.classInfos.empty() && fileInfo.second.structInfos.empty())
+			continue;
+
+		// Source files include their own header, so their includes contribute as well. Generated headers are skipped as 
+		// they change often and would invalidate the precompiled header.
+		std::vector<std::string> includes = fileInfo.second.referencedHeaderIncludes;
+		includes.insert(includes.end(), fileInfo.second.referencedSourceIncludes.begin(), 
+			fileInfo.second.referencedSourceIncludes.end());
+
+		removeRedundantIncludes(includes, {});
+		for (auto& include : includes)
+		{
+			if (StringRef(include).endswith(".generated.h"))
+				continue;
+
+			auto iterFind = frequencies.find(include);
+			if (iterFind == frequencies.end())
+			{
+				frequencies[include] = { 1, (int)orderedIncludes.size() };
+				orderedIncludes.push_back(include);
+			}
+			else
+				iterFind->second.count++;
+		}
+
+		numSources++;
+	}
+
+	int minCount = std::max(1, (int)std::ceil(numSources * MIN_INCLUDE_FREQUENCY));
+	auto iterEnd = std::remove_if(orderedIncludes.begin(), orderedIncludes.end(), 
+		[&frequencies, minCount](const std::string& include)
+	{
+		return frequencies[include].count < minCount;
+	});
+	orderedIncludes.erase(iterEnd, orderedIncludes.end());
+
+	// Most frequent includes first, as those are the prerequisites the other headers depend on. Otherwise keep the order
+	// in which they were first included by the generated files.
+	std::stable_sort(orderedIncludes.begin(), orderedIncludes.end(), 
+		[&frequencies](const std::string& a, const std::string& b)
+	{
+		return frequencies[a].count > frequencies[b].count;
+	});
+
+	CodeWriter output;
+
+	// License/copyright header
+	output << generateFileHeader(editor);
+
+	output << "#pragma once\n";
+	output << "\n";
+
+	// Always written as the generated CMake source list references it, even if there are no sources to analyze
+	if (orderedIncludes.empty())
+		output << "#include \"BsScript" << (editor ? "Editor" : "Engine") << "Prerequisites.h\"\n";
+
+	for (auto& include : orderedIncludes)
+		output << "#include \"" << getRelativeTo(include, cppOutputFolder) << "\"\n";
+
+	writeFile(std::string("BsScript") + (editor ? "Editor" : "Engine") + "PCH.generated.h", cppOutputFolder, output, 
+		files);
+}
+
+/** 
+ * Generates a CMake file listing all C++ sources generated in the provided folder, along with the generated precompiled 
+ * header. Must be called after all the C++ sources have been generated.
+ */
+void generateCMakeSourceList(bool editor, StringRef cppOutputFolder, GeneratedFiles& files)
+{
+	std::string prefix = editor ? "EDITOR" : "ENGINE";
+	std::string pchName = std::string("BsScript") + (editor ? "Editor" : "Engine") + "PCH.generated.h";
+
+	// Note: Path separators are normalized by comparing the paths in the same way as they were created
+	std::string folderPath = sys::path::parent_path(getOutputPath(pchName, cppOutputFolder));
+
+	CodeWriter output;
+	output << "# Generated by BansheeSBGen. Do not modify.\n";
+	output << "#\n";
+	output << "# Usage:\n";
+	output << "#   target_sources(<target> PRIVATE ${BS_SCRIPT_" << prefix << "_GENERATED_SOURCES})\n";
+	output << "#   target_precompile_headers(<target> PRIVATE ${BS_SCRIPT_" << prefix << "_GENERATED_PCH})\n";
+	output << "\n";
+
+	output << "set(BS_SCRIPT_" << prefix << "_GENERATED_SOURCES\n";
+	for (auto& entry : files)
+	{
+		StringRef path = entry.first;
+		if (!path.endswith(".generated.cpp") || sys::path::parent_path(path) != folderPath)
+			continue;
+
+		output << "\t\"${CMAKE_CURRENT_LIST_DIR}/" << sys::path::filename(path) << "\"\n";
+	}
+	output << ")\n";
+	output << "\n";
+
+	output << "set(BS_SCRIPT_" << prefix << "_GENERATED_PCH \"${CMAKE_CURRENT_LIST_DIR}/" << pchName << "\")\n";
+
+	writeFile(std::string("BsScript") + (editor ? "Editor" : "Engine") + "Sources.generated.cmake", cppOutputFolder, 
+		output, files);
+}
+
+/** 
+ * Generates a micro-benchmark comparing the call overhead of leaf methods forwarded directly (see isLeafMethod()), 
+ * against the same methods going through the generic conversion code. Static and module property getters without 
+ * parameters are benchmarked, as they can be called without an object instance and without side effects.
+ *
+ * Also benchmarks the cost of connecting and firing per-instance events through a bound member function, compared to
+ * the capturing lambda used by the interop objects (see generateCppEventCallbackLambda()). This benchmark is synthetic,
+ * it uses events with a void(UINT32) signature, in the same number as the per-instance events of the types with the 
+ * most such events.
+ */
+void generateCallBenchmarkFile(bool editor, StringRef cppOutputFolder, GeneratedFiles& files)
+{
+	const int MAX_BENCHMARKED_METHODS = 16;
+
+	std::string prefix = editor ? "Editor" : "";
+	std::string headerName = "BsScript" + prefix + "CallBenchmark.generated.h";
+	std::string functionName = "runScript" + prefix + "CallBenchmark";
+	std::string resultName = "Script" + prefix + "CallBenchmarkResult";
+
+	CodeWriter includes;
+	CodeWriter thunks;
+	CodeWriter body;
+
+	int numMethods = 0;
+	for (auto& fileInfo : outputFileInfos)
+	{
+		if (fileInfo.second.inEditor != editor)
+			continue;
+
+		for (auto& classInfo : fileInfo.second.classInfos)
+		{
+			UserTypeInfo& typeInfo = cppToCsTypeMap[classInfo.name];
+			bool isModule = (classInfo.flags & (int)ClassFlags::IsModule) != 0;
+
+			bool hasMethods = false;
+			for (auto& methodInfo : classInfo.methodInfos)
+			{
+				if (numMethods >= MAX_BENCHMARKED_METHODS)
+					break;
+
+				bool isStatic = (methodInfo.flags & (int)MethodFlags::Static) != 0;
+				bool isGetter = (methodInfo.flags & (int)MethodFlags::PropertyGetter) != 0;
+				bool isExternal = (methodInfo.flags & (int)MethodFlags::External) != 0;
+
+				if (!isGetter || isExternal || (!isStatic && !isModule) || !methodInfo.paramInfos.empty() || 
+					methodInfo.api != classInfo.api || !isLeafMethod(methodInfo))
+					continue;
+
+				// Both versions are generated under unique names, as they cannot access the private thunks of the 
+				// interop class
+				std::string index = std::to_string(numMethods);
+
+				MethodInfo leafMethodInfo = methodInfo;
+				leafMethodInfo.interopName = "Leaf" + index + "_" + methodInfo.interopName;
+
+				MethodInfo genericMethodInfo = methodInfo;
+				genericMethodInfo.interopName = "Generic" + index + "_" + methodInfo.interopName;
+
+				std::string interopClassName = getScriptInteropType(classInfo.name);
+
+				thunks << generateCppApiCheckBegin(classInfo.api);
+				thunks << "\t" << generateCppMethodSignature(leafMethodInfo, "", "", isModule) << "\n";
+				generateCppMethodBody(classInfo, leafMethodInfo, classInfo.name, interopClassName, typeInfo.type, isModule, 
+					thunks);
+				thunks << "\n";
+				thunks << "\t" << generateCppMethodSignature(genericMethodInfo, "", "", isModule) << "\n";
+				generateCppMethodBody(classInfo, genericMethodInfo, classInfo.name, interopClassName, typeInfo.type, 
+					isModule, thunks, false);
+				thunks << generateApiCheckEnd(classInfo.api);
+				thunks << "\n";
+
+				const ReturnInfo& returnInfo = methodInfo.returnInfo;
+				UserTypeInfo returnTypeInfo = getTypeInfo(returnInfo.typeName, returnInfo.flags);
+				bool returnByParam = !canBeReturned(returnTypeInfo.type, returnInfo.flags);
+				std::string returnType = getInteropCppVarType(returnInfo.typeName, returnTypeInfo.type, returnInfo.flags);
+
+				auto generateLoop = [&](const MethodInfo& calledMethodInfo, const std::string& resultName)
+				{
+					// Called through a volatile function pointer, same as the runtime calls internal calls. This
+					// prevents the compiler from inlining the thunks into the loop.
+					std::string funcName = resultName + "Func";
+					body << "\t\t\tdecltype(&Internal_" << calledMethodInfo.interopName << ") volatile " << funcName << 
+						" = &Internal_" << calledMethodInfo.interopName << ";\n";
+
+					body << "\t\t\tstart = Clock::now();\n";
+					body << "\t\t\tfor(UINT32 i = 0; i < iterations; i++)\n";
+					body << "\t\t\t{\n";
+
+					if (returnByParam)
+					{
+						body << "\t\t\t\t" << returnType << " value;\n";
+						body << "\t\t\t\t" << funcName << "(&value);\n";
+					}
+					else
+						body << "\t\t\t\t" << returnType << " value = " << funcName << "();\n";
+
+					body << "\t\t\t\tsink ^= *(const UINT8*)&value;\n";
+					body << "\t\t\t}\n";
+					body << "\t\t\tresult." << resultName << " = (UINT64)std::chrono::duration_cast<std::chrono::nanoseconds>(" <<
+						"Clock::now() - start).count();\n";
+				};
+
+				body << generateCppApiCheckBegin(classInfo.api);
+				body << "\t\t{\n";
+				body << "\t\t\t" << resultName << " result;\n";
+				body << "\t\t\tresult.method = \"" << classInfo.name << "::" << methodInfo.sourceName << "\";\n";
+				body << "\n";
+				generateLoop(leafMethodInfo, "leafNs");
+				body << "\n";
+				generateLoop(genericMethodInfo, "genericNs");
+				body << "\n";
+				body << "\t\t\toutput.push_back(result);\n";
+				body << "\t\t}\n";
+				body << generateApiCheckEnd(classInfo.api);
+
+				hasMethods = true;
+				numMethods++;
+			}
+
+			if (hasMethods)
+			{
+				includes << generateCppApiCheckBegin(classInfo.api);
+				includes << "#include \"" << getRelativeTo(typeInfo.declFile, cppOutputFolder) << "\"\n";
+				includes << generateApiCheckEnd(classInfo.api);
+			}
+		}
+	}
+
+	// Find the types with the most per-instance events
+	const int MAX_BENCHMARKED_EVENT_TYPES = 16;
+	std::string eventFunctionName = "runScript" + prefix + "EventBenchmark";
+	std::string eventResultName = "Script" + prefix + "EventBenchmarkResult";
+
+	std::vector<std::pair<std::string, int>> eventTypes;
+	for (auto& fileInfo : outputFileInfos)
+	{
+		if (fileInfo.second.inEditor != editor)
+			continue;
+
+		for (auto& classInfo : fileInfo.second.classInfos)
+		{
+			bool isModule = (classInfo.flags & (int)ClassFlags::IsModule) != 0;
+			if (isModule)
+				continue;
+
+			int numEvents = 0;
+			for (auto& eventInfo : classInfo.eventInfos)
+			{
+				bool isStatic = (eventInfo.flags & (int)MethodFlags::Static) != 0;
+				bool isCallback = (eventInfo.flags & (int)MethodFlags::Callback) != 0;
+				if (!isStatic && !isCallback)
+					numEvents++;
+			}
+
+			if (numEvents > 0)
+				eventTypes.push_back(std::make_pair(classInfo.name, numEvents));
+		}
+	}
+
+	std::stable_sort(eventTypes.begin(), eventTypes.end(), 
+		[](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) { return a.second > b.second; });
+
+	if (eventTypes.size() > MAX_BENCHMARKED_EVENT_TYPES)
+		eventTypes.resize(MAX_BENCHMARKED_EVENT_TYPES);
+
+	std::string ns = editor ? sEditorCppNs : sFrameworkCppNs;
+
+	// Header
+	CodeWriter header;
+	header << generateFileHeader(editor);
+	header << "#pragma once\n";
+	header << "\n";
+	header << "#include \"BsScript" << (editor ? "Editor" : "Engine") << "Prerequisites.h\"\n";
+	header << "\n";
+	header << "namespace " << ns << "\n";
+	header << "{\n";
+
+	header << "\t/** Total time spent calling a method through its leaf and through its generic interop thunk. */\n";
+	header << "\tstruct " << resultName << "\n";
+	header << "\t{\n";
+	header << "\t\tconst char* method;\n";
+	header << "\t\tUINT64 leafNs;\n";
+	header << "\t\tUINT64 genericNs;\n";
+	header << "\t};\n";
+	header << "\n";
+
+	header << "\t/** Calls every benchmarked method @p iterations times through both of its thunks, and returns the timings. */\n";
+	header << "\t" << (editor ? sEditorExportMacro : sFrameworkExportMacro) << " Vector<" << resultName << "> " << 
+		functionName << "(UINT32 iterations);\n";
+	header << "\n";
+
+	header << "\t/** \n";
+	header << "\t * Total time spent connecting and disconnecting, and firing synthetic events, through a bound member function\n";
+	header << "\t * and through a capturing lambda. Events use a void(UINT32) signature instead of the real event signatures, and\n";
+	header << "\t * their number matches the number of per-instance events of the modeled type.\n";
+	header << "\t */\n";
+	header << "\tstruct " << eventResultName << "\n";
+	header << "\t{\n";
+	header << "\t\tconst char* modeledType;\n";
+	header << "\t\tUINT32 numEvents;\n";
+	header << "\t\tUINT64 bindConnectNs;\n";
+	header << "\t\tUINT64 lambdaConnectNs;\n";
+	header << "\t\tUINT64 bindFireNs;\n";
+	header << "\t\tUINT64 lambdaFireNs;\n";
+	header << "\t};\n";
+	header << "\n";
+
+	header << "\t/** \n";
+	header << "\t * For every modeled type, connects and disconnects as many synthetic events as the type has per-instance events\n";
+	header << "\t * @p iterations times, fires each of them @p iterations times, and returns the timings.\n";
+	header << "\t */\n";
+	header << "\t" << (editor ? sEditorExportMacro : sFrameworkExportMacro) << " Vector<" << eventResultName << "> " << 
+		eventFunctionName << "(UINT32 iterations);\n";
+	header << "}\n";
+
+	writeFile(headerName, cppOutputFolder, header, files);
+
+	// Source
+	CodeWriter output(thunks.size() + body.size() + 4096);
+	output << generateFileHeader(editor);
+	output << "#include \"" << headerName << "\"\n";
+
+	output << "#include <chrono>\n";
+	output << includes;
+	output << "\n";
+	output << "namespace " << ns << "\n";
+	output << "{\n";
+	output << "\tnamespace\n";
+	output << "\t{\n";
+	output << thunks;
+	output << "\t}\n";
+	output << "\n";
+	output << "\tVector<" << resultName << "> " << functionName << "(UINT32 iterations)\n";
+	output << "\t{\n";
+	output << "\t\tusing Clock = std::chrono::high_resolution_clock;\n";
+	output << "\n";
+	output << "\t\tVector<" << resultName << "> output;\n";
+	output << "\t\tClock::time_point start;\n";
+	output << "\t\tvolatile UINT8 sink = 0;\n";
+	output << "\n";
+	output << body;
+	output << "\n";
+	output << "\t\treturn output;\n";
+	output << "\t}\n";
+	output << "\n";
+
+	// Event benchmark. Events are synthetic and share the same signature for all modeled types, only their number is 
+	// taken from the real types.
+	output << "\tnamespace\n";
+	output << "\t{\n";
+	output << "\t\tstruct EventBenchmarkReceiver\n";
+	output << "\t\t{\n";
+	output << "\t\t\tvoid onEvent(UINT32 value) { sum = sum + value; }\n";
+	output << "\n";
+	output << "\t\t\tvolatile UINT32 sum = 0;\n";
+	output << "\t\t};\n";
+	output << "\n";
+	output << "\t\ttemplate<UINT32 NumEvents>\n";
+	output << "\t\tvoid benchmarkEvents(const char* modeledType, UINT32 iterations, Vector<" << eventResultName << 
+		">& output)\n";
+	output << "\t\t{\n";
+	output << "\t\t\tusing Clock = std::chrono::high_resolution_clock;\n";
+	output << "\n";
+	output << "\t\t\tEventBenchmarkReceiver receiver;\n";
+	output << "\t\t\tEventBenchmarkReceiver* receiverPtr = &receiver;\n";
+	output << "\n";
+	output << "\t\t\t" << eventResultName << " result;\n";
+	output << "\t\t\tresult.modeledType = modeledType;\n";
+	output << "\t\t\tresult.numEvents = NumEvents;\n";
+	output << "\n";
+
+	auto generateConnectLoop = [&output](const std::string& connectArg, const std::string& resultField)
+	{
+		// Events are constructed outside of the timed region, so only connecting and disconnecting is measured
+		output << "\t\t\t{\n";
+		output << "\t\t\t\tEvent<void(UINT32)> events[NumEvents];\n";
+		output << "\t\t\t\tHEvent connections[NumEvents];\n";
+		output << "\n";
+		output << "\t\t\t\tClock::time_point start = Clock::now();\n";
+		output << "\t\t\t\tfor(UINT32 i = 0; i < iterations; i++)\n";
+		output << "\t\t\t\t{\n";
+		output << "\t\t\t\t\tfor(UINT32 j = 0; j < NumEvents; j++)\n";
+		output << "\t\t\t\t\t\tconnections[j] = events[j].connect(" << connectArg << ");\n";
+		output << "\n";
+		output << "\t\t\t\t\tfor(auto& connection : connections)\n";
+		output << "\t\t\t\t\t\tconnection.disconnect();\n";
+		output << "\t\t\t\t}\n";
+		output << "\t\t\t\tresult." << resultField << " = (UINT64)std::chrono::duration_cast<std::chrono::nanoseconds>(" <<
+			"Clock::now() - start).count();\n";
+		output << "\t\t\t}\n";
+		output << "\n";
+	};
+
+	auto generateFireLoop = [&output](const std::string& connectArg, const std::string& resultField)
+	{
+		output << "\t\t\t{\n";
+		output << "\t\t\t\tEvent<void(UINT32)> events[NumEvents];\n";
+		output << "\t\t\t\tfor(auto& event : events)\n";
+		output << "\t\t\t\t\tevent.connect(" << connectArg << ");\n";
+		output << "\n";
+		output << "\t\t\t\tClock::time_point start = Clock::now();\n";
+		output << "\t\t\t\tfor(UINT32 i = 0; i < iterations; i++)\n";
+		output << "\t\t\t\t{\n";
+		output << "\t\t\t\t\tfor(auto& event : events)\n";
+		output << "\t\t\t\t\t\tevent(i);\n";
+		output << "\t\t\t\t}\n";
+		output << "\t\t\t\tresult." << resultField << " = (UINT64)std::chrono::duration_cast<std::chrono::nanoseconds>(" <<
+			"Clock::now() - start).count();\n";
+		output << "\t\t\t}\n";
+		output << "\n";
+	};
+
+	std::string bindArg = "std::bind(&EventBenchmarkReceiver::onEvent, receiverPtr, std::placeholders::_1)";
+	std::string lambdaArg = "[receiverPtr](UINT32 p0) { receiverPtr->onEvent(p0); }";
+
+	generateConnectLoop(bindArg, "bindConnectNs");
+	generateConnectLoop(lambdaArg, "lambdaConnectNs");
+	generateFireLoop(bindArg, "bindFireNs");
+	generateFireLoop(lambdaArg, "lambdaFireNs");
+
+	output << "\t\t\toutput.push_back(result);\n";
+	output << "\t\t}\n";
+	output << "\t}\n";
+	output << "\n";
+	output << "\tVector<" << eventResultName << "> " << eventFunctionName << "(UINT32 iterations)\n";
+	output << "\t{\n";
+	output << "\t\tVector<" << eventResultName << "> output;\n";
+
+	for (auto& entry : eventTypes)
+		output << "\t\tbenchmarkEvents<" << entry.second << ">(\"" << entry.first << "\", iterations, output);\n";
+
+	output << "\n";
+	output << "\t\treturn output;\n";
+	output << "\t}\n";
+	output << "}\n";
+
+	writeFile("BsScript" + prefix + "CallBenchmark.generated.cpp", cppOutputFolder, output, files);
+}
+
+/** 
+ * Generates a single entry point that delivers the queued fires of all deferred events (see generateCppEventFlush()) to
+ * managed code. The file is generated even if there are no deferred events, so the runtime can always call it.
+ */
+void generateDeferredEventsFile(bool editor, StringRef cppOutputFolder, GeneratedFiles& files)
+{
+	std::string prefix = editor ? "Editor" : "";
+	std::string headerName = "BsScript" + prefix + "DeferredEvents.generated.h";
+	std::string functionName = "flushScript" + prefix + "DeferredEvents";
+
+	CodeWriter includes;
+	CodeWriter body;
+
+	for (auto& fileInfo : outputFileInfos)
+	{
+		if (fileInfo.second.inEditor != editor)
+			continue;
+
+		bool hasIncludes = false;
+		for (auto& classInfo : fileInfo.second.classInfos)
+		{
+			if (!hasDeferredEvents(classInfo))
+				continue;
+
+			if (!hasIncludes)
+			{
+				includes << "#include \"BsScript" << fileInfo.first << ".generated.h\"\n";
+				hasIncludes = true;
+			}
+
+			body << generateCppApiCheckBegin(classInfo.api);
+			body << "\t\t" << getScriptInteropType(classInfo.name) << "::flushEvents();\n";
+			body << generateApiCheckEnd(classInfo.api);
+		}
+	}
+
+	std::string ns = editor ? sEditorCppNs : sFrameworkCppNs;
+
+	// Header
+	CodeWriter header;
+	header << generateFileHeader(editor);
+	header << "#pragma once\n";
+	header << "\n";
+	header << "#include \"BsScript" << (editor ? "Editor" : "Engine") << "Prerequisites.h\"\n";
+	header << "\n";
+	header << "namespace " << ns << "\n";
+	header << "{\n";
+	header << "\t/** \n";
+	header << "\t * Delivers all queued fires of events exported as deferred to managed code. Until this is called such events\n";
+	header << "\t * never reach managed code, so the runtime must call it on the main thread once per frame, before scripts\n";
+	header << "\t * are updated.\n";
+	header << "\t */\n";
+	header << "\t" << (editor ? sEditorExportMacro : sFrameworkExportMacro) << " void " << functionName << "();\n";
+	header << "}\n";
+
+	writeFile(headerName, cppOutputFolder, header, files);
+
+	// Source
+	CodeWriter output(body.size() + includes.size() + 1024);
+	output << generateFileHeader(editor);
+	output << "#include \"" << headerName << "\"\n";
+	output << includes;
+	output << "\n";
+	output << "namespace " << ns << "\n";
+	output << "{\n";
+	output << "\tvoid " << functionName << "()\n";
+	output << "\t{\n";
+	output << body;
+	output << "\t}\n";
+	output << "}\n";
+
+	writeFile("BsScript" + prefix + "DeferredEvents.generated.cpp", cppOutputFolder, output, files);
+}
+
+/** 
+ * Generates the contents of all output files from the post-processed file information. Returns false if any of the files
+ * could not be generated.
+ */
+bool generateFiles(StringRef cppEngineOutputFolder, StringRef cppEditorOutputFolder, StringRef csEngineOutputFolder, 
+	StringRef csEditorOutputFolder, bool genEditor, GeneratedFiles& files)
+{
+	// Note: Buffer is re-used for all files, so it only needs to grow once
+	CodeWriter output(1024 * 1024);
+
+	// Generate H
+	for (auto& fileInfo : outputFileInfos)
+	{
+		if(fileInfo.second.inEditor && !genEditor)
+			continue;
+
+		auto& classInfos = fileInfo.second.classInfos;
+		auto& structInfos = fileInfo.second.structInfos;
+
+		if (classInfos.empty() && structInfos.empty())
+			continue;
+
+		StringRef cppOutputFolder = fileInfo.second.inEditor ? cppEditorOutputFolder : cppEngineOutputFolder;
+		output.clear();
+
+		// License/copyright header
+		output << generateFileHeader(fileInfo.second.inEditor);
+
+		output << "#pragma once\n";
+		output << "\n";
+
+		// Output includes
+		for (auto& include : fileInfo.second.referencedHeaderIncludes)
+			output << "#include \"" << getRelativeTo(include, cppOutputFolder) << "\"\n";
+
+		output << "\n";
+
+		// Output forward declarations
+		for (auto& decl : fileInfo.second.forwardDeclarations)
+		{
+			for (auto& nsEntry : decl.ns)
+				output << "namespace " << nsEntry << " { ";
+			
+			if (decl.templParams.size() > 0)
+			{
 				output << "template<";
 
-				for (int i = 0; i < (int)decl.templParams.size(); ++i)
-				{
-					if (i != 0)
-						output << ", ";
+				for (int i = 0; i < (int)decl.templParams.size(); ++i)
+				{
+					if (i != 0)
+						output << ", ";
+
+					output << decl.templParams[i].type << " T" << std::to_string(i);
+				}
+
+				output << "> ";
+			}
+
+			if (decl.isStruct)
+				output << "struct " << decl.name << ";";
+			else
+				output << "class " << decl.name << ";";
+
+			for (auto& nsEntry : decl.ns)
+				output << " }";
+			
+			output << "\n";
+		}
+
+		output << "namespace " << (fileInfo.second.inEditor ? sEditorCppNs : sFrameworkCppNs) << "\n";
+		output << "{\n";
+
+		for (auto I = classInfos.begin(); I != classInfos.end(); ++I)
+		{
+			ClassInfo& classInfo = *I;
+			UserTypeInfo& typeInfo = cppToCsTypeMap[classInfo.name];
+
+			generateCppHeaderOutput(classInfo, typeInfo, output);
+
+			if ((I + 1) != classInfos.end() || !structInfos.empty())
+				output << "\n";
+		}
+
+		for (auto I = structInfos.begin(); I != structInfos.end(); ++I)
+		{
+			StructInfo& structInfo = *I;
+			generateCppStructHeader(structInfo, output);
+
+			if ((I + 1) != structInfos.end())
+				output << "\n";
+		}
+
+		output << "}\n";
+
+		writeFile("BsScript" + fileInfo.first + ".generated.h", cppOutputFolder, output, files);
+	}
+
+	// Generate CPP
+	if (sNumSourceShards > 0)
+	{
+		generateSourceShards(false, cppEngineOutputFolder, output, files);
+
+		if (genEditor)
+			generateSourceShards(true, cppEditorOutputFolder, output, files);
+	}
+	else
+	{
+		for (auto& fileInfo : outputFileInfos)
+		{
+			if(fileInfo.second.inEditor && !genEditor)
+				continue;
+
+			// Generated as a part of a unity source below
+			if (isUnityBuildFile(fileInfo.second))
+				continue;
+
+			auto& classInfos = fileInfo.second.classInfos;
+			auto& structInfos = fileInfo.second.structInfos;
+
+			if (classInfos.empty() && structInfos.empty())
+				continue;
+
+			StringRef cppOutputFolder = fileInfo.second.inEditor ? cppEditorOutputFolder : cppEngineOutputFolder;
+			output.clear();
+
+			// License/copyright header
+			output << generateFileHeader(fileInfo.second.inEditor);
+
+			// Output includes
+			for (auto& include : fileInfo.second.referencedSourceIncludes)
+				output << "#include \"" << getRelativeTo(include, cppOutputFolder) << "\"\n";
 
-					output << decl.templParams[i].type << " T" << std::to_string(i);
-				}
+			output << "\n";
 
-				output << "> ";
+			output << "namespace " << (fileInfo.second.inEditor ? sEditorCppNs : sFrameworkCppNs) << "\n";
+			output << "{\n";
+
+			for (auto I = classInfos.begin(); I != classInfos.end(); ++I)
+			{
+				ClassInfo& classInfo = *I;
+				UserTypeInfo& typeInfo = cppToCsTypeMap[classInfo.name];
+
+				generateCppSourceOutput(classInfo, typeInfo, output);
+
+				if ((I + 1) != classInfos.end() || !structInfos.empty())
+					output << "\n";
 			}
 
-			if (decl.isStruct)
-				output << "struct " << decl.name << ";";
-			else
-				output << "class " << decl.name << ";";
+			for (auto I = structInfos.begin(); I != structInfos.end(); ++I)
+			{
+				generateCppStructSource(*I, output);
 
-			for (auto& nsEntry : decl.ns)
-				output << " }";
-			
-			output << "\n";
+				if ((I + 1) != structInfos.end())
+					output << "\n";
+			}
+
+			output << "}\n";
+
+			writeFile("BsScript" + fileInfo.first + ".generated.cpp", cppOutputFolder, output, files);
 		}
 
-		output << "namespace " << (fileInfo.second.inEditor ? sEditorCppNs : sFrameworkCppNs) << std::endl;
-		output << "{" << std::endl;
-		output << body.str();
-		output << "}" << std::endl;
+		if (sUnityBuildSize > 0)
+		{
+			generateUnitySources(false, cppEngineOutputFolder, output, files);
 
-		output.close();
+			if (genEditor)
+				generateUnitySources(true, cppEditorOutputFolder, output, files);
+		}
 	}
 
-	// Generate CPP
+	// Generate CS
 	for (auto& fileInfo : outputFileInfos)
 	{
 		if(fileInfo.second.inEditor && !genEditor)
 			continue;
 
-		std::stringstream body;
-
 		auto& classInfos = fileInfo.second.classInfos;
 		auto& structInfos = fileInfo.second.structInfos;
+		auto& enumInfos = fileInfo.second.enumInfos;
 
-		if (classInfos.empty() && structInfos.empty())
+		if (classInfos.empty() && structInfos.empty() && enumInfos.empty())
 			continue;
 
+		StringRef csOutputFolder = fileInfo.second.inEditor ? csEditorOutputFolder : csEngineOutputFolder;
+		output.clear();
+
+		// License/copyright header
+		output << generateFileHeader(fileInfo.second.inEditor);
+
+		output << "using System;\n";
+		output << "using System.Runtime.CompilerServices;\n";
+		output << "using System.Runtime.InteropServices;\n";
+
+		if (fileInfo.second.inEditor)
+			output << "using " << sFrameworkCsNs << ";\n";
+
+		output << "\n";
+
+		if (!fileInfo.second.inEditor)
+			output << "namespace " << sFrameworkCsNs << "\n";
+		else
+			output << "namespace " << sEditorCsNs << "\n";
+
+		output << "{\n";
+
 		for (auto I = classInfos.begin(); I != classInfos.end(); ++I)
 		{
 			ClassInfo& classInfo = *I;
 			UserTypeInfo& typeInfo = cppToCsTypeMap[classInfo.name];
 
-			body << generateCppSourceOutput(classInfo, typeInfo);
+			generateCSClass(classInfo, typeInfo, output);
 
-			if ((I + 1) != classInfos.end() || !structInfos.empty())
-				body << std::endl;
+			if ((I + 1) != classInfos.end() || !structInfos.empty() || !enumInfos.empty())
+				output << "\n";
 		}
 
 		for (auto I = structInfos.begin(); I != structInfos.end(); ++I)
 		{
-			body << generateCppStructSource(*I);
+			generateCSStruct(*I, output);
 
-			if ((I + 1) != structInfos.end())
-				body << std::endl;
+			if ((I + 1) != structInfos.end() || !enumInfos.empty())
+				output << "\n";
 		}
 
-		StringRef cppOutputFolder = fileInfo.second.inEditor ? cppEditorOutputFolder : cppEngineOutputFolder;
-		std::ofstream output = createFile("BsScript" + fileInfo.first + ".generated.cpp", cppOutputFolder);
+		for (auto I = enumInfos.begin(); I != enumInfos.end(); ++I)
+		{
+			generateCSEnum(*I, output);
 
-		// License/copyright header
-		output << generateFileHeader(fileInfo.second.inEditor);
+			if ((I + 1) != enumInfos.end())
+				output << "\n";
+		}
 
-		// Output includes
-		for (auto& include : fileInfo.second.referencedSourceIncludes)
-			output << "#include \"" << getRelativeTo(include, cppOutputFolder) << "\"" << std::endl;
+		output << "}\n";
+
+		writeFile(fileInfo.first + ".generated.cs", csOutputFolder, output, files);
+	}
 
-		output << std::endl;
+	// Generate builtin component lookup file
+	bool succeeded = true;
+	succeeded &= generateLookupFile("BuiltinComponent", ParsedType::Component, false, cppEngineOutputFolder, cppEditorOutputFolder, files);
+
+	// Generate C++ reflectable type lookup files
+	succeeded &= generateLookupFile("BuiltinReflectableTypes", ParsedType::ReflectableClass, false, cppEngineOutputFolder, cppEditorOutputFolder, files);
+	succeeded &= generateLookupFile("BuiltinReflectableTypes", ParsedType::ReflectableClass, true, cppEngineOutputFolder, cppEditorOutputFolder, files);
 
-		output << "namespace " << (fileInfo.second.inEditor ? sEditorCppNs : sFrameworkCppNs) << std::endl;
-		output << "{" << std::endl;
-		output << body.str();
-		output << "}" << std::endl;
+	// Generate the flush entry point for deferred events
+	generateDeferredEventsFile(false, cppEngineOutputFolder, files);
 
-		output.close();
+	if(genEditor)
+		generateDeferredEventsFile(true, cppEditorOutputFolder, files);
+
+	if(sGenerateCallBenchmark)
+	{
+		generateCallBenchmarkFile(false, cppEngineOutputFolder, files);
+
+		if(genEditor)
+			generateCallBenchmarkFile(true, cppEditorOutputFolder, files);
 	}
 
-	// Generate CS
-	for (auto& fileInfo : outputFileInfos)
+	// Generate precompiled headers and source lists for the build
+	generatePrecompiledHeader(false, cppEngineOutputFolder, files);
+	generateCMakeSourceList(false, cppEngineOutputFolder, files);
+
+	if(genEditor)
 	{
-		if(fileInfo.second.inEditor && !genEditor)
-			continue;
+		generatePrecompiledHeader(true, cppEditorOutputFolder, files);
+		generateCMakeSourceList(true, cppEditorOutputFolder, files);
+	}
+
+	// Generate XML lookup
+	generateMappingXMLFile(false, csEngineOutputFolder, files);
 
-		std::stringstream body;
+	if(genEditor)
+		generateMappingXMLFile(true, csEditorOutputFolder, files);
 
-		auto& classInfos = fileInfo.second.classInfos;
-		auto& structInfos = fileInfo.second.structInfos;
-		auto& enumInfos = fileInfo.second.enumInfos;
+	if(sGenerateBinaryInfo)
+	{
+		generateBinaryInfoFile(false, csEngineOutputFolder, files);
 
-		if (classInfos.empty() && structInfos.empty() && enumInfos.empty())
+		if(genEditor)
+			generateBinaryInfoFile(true, csEditorOutputFolder, files);
+	}
+
+	return succeeded;
+}
+
+/** Size and complexity metrics of the code generated for a single exported file. */
+struct FileCostInfo
+{
+	int numInternalCalls = 0;
+	int numEvents = 0;
+	int numComplexStructs = 0;
+	int numArrayLoops = 0;
+	int numGeneratedLines = 0;
+	int numIncludedBy = 0;
+};
+
+/** Size of the generated C++ body of a single method. */
+struct MethodCostInfo
+{
+	std::string name;
+	int size;
+};
+
+/** Returns the number of lines in the provided code. */
+int countLines(const CodeWriter& code)
+{
+	return (int)std::count(code.data(), code.data() + code.size(), '\n');
+}
+
+/** 
+ * Calculates size and complexity metrics of the code generated for the provided file, by generating it into a temporary
+ * buffer. Sizes of the generated C++ method bodies are appended to @p methodCosts.
+ */
+FileCostInfo calculateFileCost(FileInfo& fileInfo, std::vector<MethodCostInfo>& methodCosts)
+{
+	FileCostInfo output;
+
+	auto countArrays = [&output](const MethodInfo& methodInfo)
+	{
+		for (auto& paramInfo : methodInfo.paramInfos)
+		{
+			if (isArrayOrVector(paramInfo.flags))
+				output.numArrayLoops++;
+		}
+
+		if (!methodInfo.returnInfo.typeName.empty() && isArrayOrVector(methodInfo.returnInfo.flags))
+			output.numArrayLoops++;
+	};
+
+	CodeWriter code(64 * 1024);
+	CodeWriter methodCode(4096);
+	for (auto& classInfo : fileInfo.classInfos)
+	{
+		UserTypeInfo& typeInfo = cppToCsTypeMap[classInfo.name];
+		std::string interopClassName = getScriptInteropType(classInfo.name);
+		bool isModule = (classInfo.flags & (int)ClassFlags::IsModule) != 0;
+
+		auto addMethod = [&](const MethodInfo& methodInfo)
+		{
+			if (isCSOnly(methodInfo.flags))
+				return;
+
+			output.numInternalCalls++;
+			countArrays(methodInfo);
+
+			if ((methodInfo.flags & (int)MethodFlags::FieldWrapper) != 0)
+				return;
+
+			methodCode.clear();
+			generateCppMethodBody(classInfo, methodInfo, classInfo.name, interopClassName, typeInfo.type, isModule, 
+				methodCode);
+
+			methodCosts.push_back({ classInfo.name + "::" + methodInfo.sourceName, (int)methodCode.size() });
+		};
+
+		for (auto& methodInfo : classInfo.ctorInfos)
+			addMethod(methodInfo);
+
+		for (auto& methodInfo : classInfo.methodInfos)
+			addMethod(methodInfo);
+
+		for (auto& eventInfo : classInfo.eventInfos)
+		{
+			output.numEvents++;
+			countArrays(eventInfo);
+		}
+
+		generateCppHeaderOutput(classInfo, typeInfo, code);
+		generateCppSourceOutput(classInfo, typeInfo, code);
+		generateCSClass(classInfo, typeInfo, code);
+	}
+
+	for (auto& structInfo : fileInfo.structInfos)
+	{
+		if (structInfo.requiresInterop)
+			output.numComplexStructs++;
+
+		for (auto& fieldInfo : structInfo.fields)
+		{
+			if (isArrayOrVector(fieldInfo.flags))
+				output.numArrayLoops++;
+		}
+
+		generateCppStructHeader(structInfo, code);
+		generateCppStructSource(structInfo, code);
+		generateCSStruct(structInfo, code);
+	}
+
+	for (auto& enumInfo : fileInfo.enumInfos)
+		generateCSEnum(enumInfo, code);
+
+	output.numGeneratedLines = countLines(code);
+	return output;
+}
+
+/** 
+ * Counts how many other generated files include the generated header of each file in the report. Headers included by
+ * many files are the most expensive to change, as every change recompiles all of the including files.
+ */
+void calculateIncludeFanIn(std::map<std::string, FileCostInfo>& report)
+{
+	std::unordered_map<std::string, std::string> headerToFile;
+	for (auto& entry : report)
+		headerToFile["BsScript" + entry.first + ".generated.h"] = entry.first;
+
+	for (auto& entry : report)
+	{
+		const FileInfo& fileInfo = outputFileInfos[entry.first];
+
+		// Note: Counting each including file once, even if it includes the header from both its .h and .cpp file
+		std::unordered_set<std::string> includedFiles;
+		auto addIncludes = [&](const std::vector<std::string>& includes)
+		{
+			for (auto& include : includes)
+			{
+				auto iterFind = headerToFile.find(include);
+				if (iterFind != headerToFile.end() && iterFind->second != entry.first)
+					includedFiles.insert(iterFind->second);
+			}
+		};
+
+		addIncludes(fileInfo.referencedHeaderIncludes);
+		addIncludes(fileInfo.referencedSourceIncludes);
+
+		for (auto& includedFile : includedFiles)
+			report[includedFile].numIncludedBy++;
+	}
+}
+
+/** Outputs the cost report as tab separated values, one file per line. Also used as the format of baseline files. */
+void writeCostReport(const std::map<std::string, FileCostInfo>& report, CodeWriter& output)
+{
+	output << "#File\tInternal calls\tEvents\tComplex structs\tArray loops\tGenerated lines\tIncluded by\n";
+	for (auto& entry : report)
+	{
+		const FileCostInfo& cost = entry.second;
+
+		output << entry.first << "\t" << cost.numInternalCalls << "\t" << cost.numEvents << "\t" << 
+			cost.numComplexStructs << "\t" << cost.numArrayLoops << "\t" << cost.numGeneratedLines << "\t" << 
+			cost.numIncludedBy << "\n";
+	}
+}
+
+/** Reads a cost report previously output by writeCostReport(). Returns false if the file cannot be read. */
+bool readCostReport(const std::string& path, std::map<std::string, FileCostInfo>& output)
+{
+	std::ifstream input(path);
+	if (!input.is_open())
+		return false;
+
+	std::string line;
+	while (std::getline(input, line))
+	{
+		StringRef lineRef(line);
+		if (lineRef.empty() || lineRef.startswith("#"))
 			continue;
 
-		for (auto I = classInfos.begin(); I != classInfos.end(); ++I)
+		SmallVector<StringRef, 8> columns;
+		lineRef.split(columns, '\t');
+
+		if (columns.size() != 7)
 		{
-			ClassInfo& classInfo = *I;
-			UserTypeInfo& typeInfo = cppToCsTypeMap[classInfo.name];
+			outs() << "Warning: Ignoring malformed line in cost baseline \"" << path << "\": " << line << "\n";
+			continue;
+		}
 
-			body << generateCSClass(classInfo, typeInfo);
+		FileCostInfo cost;
+		int* values[] = { &cost.numInternalCalls, &cost.numEvents, &cost.numComplexStructs, &cost.numArrayLoops,
+			&cost.numGeneratedLines, &cost.numIncludedBy };
 
-			if ((I + 1) != classInfos.end() || !structInfos.empty() || !enumInfos.empty())
-				body << std::endl;
+		bool isValid = true;
+		for (int i = 0; i < 6; i++)
+		{
+			// Note: getAsInteger() returns true on failure
+			if (columns[i + 1].getAsInteger(10, *values[i]))
+			{
+				isValid = false;
+				break;
+			}
 		}
 
-		for (auto I = structInfos.begin(); I != structInfos.end(); ++I)
+		if (!isValid)
 		{
-			body << generateCSStruct(*I);
+			outs() << "Warning: Ignoring malformed line in cost baseline \"" << path << "\": " << line << "\n";
+			continue;
+		}
 
-			if ((I + 1) != structInfos.end() || !enumInfos.empty())
-				body << std::endl;
+		output[columns[0]] = cost;
+	}
+
+	return true;
+}
+
+/** 
+ * Compares the cost report against the baseline and outputs all differences. Returns false if the generated code of any 
+ * file grew significantly.
+ */
+bool compareCostReports(const std::map<std::string, FileCostInfo>& report, 
+	const std::map<std::string, FileCostInfo>& baseline)
+{
+	// Files whose generated code grows by more than this portion and number of lines are reported as errors
+	const float MAX_LINE_GROWTH = 0.1f;
+	const int MIN_REPORTED_LINE_GROWTH = 50;
+
+	bool withinLimits = true;
+	for (auto& entry : report)
+	{
+		const FileCostInfo& cost = entry.second;
+
+		auto iterFind = baseline.find(entry.first);
+		if (iterFind == baseline.end())
+		{
+			outs() << "New file \"" << entry.first << "\": " << cost.numGeneratedLines << " lines\n";
+			continue;
 		}
 
-		for (auto I = enumInfos.begin(); I != enumInfos.end(); ++I)
+		const FileCostInfo& baseCost = iterFind->second;
+		if (memcmp(&cost, &baseCost, sizeof(cost)) == 0)
+			continue;
+
+		auto printDelta = [](const char* name, int current, int base)
 		{
-			body << generateCSEnum(*I);
+			if (current != base)
+				outs() << " " << name << " " << base << " -> " << current << ";";
+		};
 
-			if ((I + 1) != enumInfos.end())
-				body << std::endl;
+		outs() << "Changed file \"" << entry.first << "\":";
+		printDelta("internal calls", cost.numInternalCalls, baseCost.numInternalCalls);
+		printDelta("events", cost.numEvents, baseCost.numEvents);
+		printDelta("complex structs", cost.numComplexStructs, baseCost.numComplexStructs);
+		printDelta("array loops", cost.numArrayLoops, baseCost.numArrayLoops);
+		printDelta("lines", cost.numGeneratedLines, baseCost.numGeneratedLines);
+		printDelta("included by", cost.numIncludedBy, baseCost.numIncludedBy);
+		outs() << "\n";
+
+		int lineGrowth = cost.numGeneratedLines - baseCost.numGeneratedLines;
+		if (lineGrowth > MIN_REPORTED_LINE_GROWTH && lineGrowth > baseCost.numGeneratedLines * MAX_LINE_GROWTH)
+		{
+			outs() << "Error: Generated code for \"" << entry.first << "\" grew by " << lineGrowth << " lines.\n";
+			withinLimits = false;
 		}
+	}
 
-		StringRef csOutputFolder = fileInfo.second.inEditor ? csEditorOutputFolder : csEngineOutputFolder;
-		std::ofstream output = createFile(fileInfo.first + ".generated.cs", csOutputFolder);
+	for (auto& entry : baseline)
+	{
+		if (report.find(entry.first) == report.end())
+			outs() << "Removed file \"" << entry.first << "\"\n";
+	}
 
-		// License/copyright header
-		output << generateFileHeader(fileInfo.second.inEditor);
+	return withinLimits;
+}
 
-		output << "using System;" << std::endl;
-		output << "using System.Runtime.CompilerServices;" << std::endl;
-		output << "using System.Runtime.InteropServices;" << std::endl;
+/** 
+ * Outputs size and complexity metrics for the code that would be generated for each file, without writing any files.
+ * Optionally saves the report and compares it against a previously saved baseline. Returns false if the generated code
+ * grew significantly compared to the baseline.
+ */
+bool generateCostReport(bool genEditor)
+{
+	const int MAX_REPORTED_METHODS = 10;
 
-		if (fileInfo.second.inEditor)
-			output << "using " << sFrameworkCsNs << ";" << std::endl;
+	std::map<std::string, FileCostInfo> report;
+	std::vector<MethodCostInfo> methodCosts;
+	for (auto& fileInfo : outputFileInfos)
+	{
+		if (fileInfo.second.inEditor && !genEditor)
+			continue;
 
-		output << std::endl;
+		report[fileInfo.first] = calculateFileCost(fileInfo.second, methodCosts);
+	}
 
-		if (!fileInfo.second.inEditor)
-			output << "namespace " << sFrameworkCsNs << "\n";
-		else
-			output << "namespace " << sEditorCsNs << "\n";
+	calculateIncludeFanIn(report);
+
+	CodeWriter reportText;
+	writeCostReport(report, reportText);
+	outs() << reportText.str();
+
+	int numReportedMethods = std::min(MAX_REPORTED_METHODS, (int)methodCosts.size());
+	std::partial_sort(methodCosts.begin(), methodCosts.begin() + numReportedMethods, methodCosts.end(), 
+		[](const MethodCostInfo& a, const MethodCostInfo& b)
+	{
+		return a.size > b.size;
+	});
 
-		output << "{" << std::endl;
-		output << body.str();
-		output << "}" << std::endl;
+	outs() << "Largest generated methods:\n";
+	for (int i = 0; i < numReportedMethods; i++)
+		outs() << "\t" << methodCosts[i].size << "\t" << methodCosts[i].name << "\n";
 
+	if (!sCostReportPath.empty())
+	{
+		// Note: Writing to a stream that failed to open fails as well
+		std::ofstream output(sCostReportPath, std::ios::out);
+		output.write(reportText.data(), reportText.size());
 		output.close();
+
+		if (output.fail())
+		{
+			outs() << "Error: Unable to write cost report \"" << sCostReportPath << "\".\n";
+			return false;
+		}
 	}
 
-	// Generate builtin component lookup file
-	generateLookupFile("BuiltinComponent", ParsedType::Component, false, cppEngineOutputFolder, cppEditorOutputFolder);
+	if (sCostBaselinePath.empty())
+		return true;
 
-	// Generate C++ reflectable type lookup files
-	generateLookupFile("BuiltinReflectableTypes", ParsedType::ReflectableClass, false, cppEngineOutputFolder, cppEditorOutputFolder);
-	generateLookupFile("BuiltinReflectableTypes", ParsedType::ReflectableClass, true, cppEngineOutputFolder, cppEditorOutputFolder);
+	std::map<std::string, FileCostInfo> baseline;
+	if (!readCostReport(sCostBaselinePath, baseline))
+	{
+		outs() << "Error: Unable to read cost baseline \"" << sCostBaselinePath << "\".\n";
+		return false;
+	}
 
-	// Generate XML lookup
-	generateMappingXMLFile(false, csEngineOutputFolder);
+	return compareCostReports(report, baseline);
+}
+
+bool generateAll(StringRef cppEngineOutputFolder, StringRef cppEditorOutputFolder, StringRef csEngineOutputFolder, 
+	StringRef csEditorOutputFolder, bool genEditor, bool checkDeterminism)
+{
+	if (sDryRun)
+	{
+		postProcessFileInfos();
+		return generateCostReport(genEditor);
+	}
+
+	// Keep a copy of the parsed information, as post-processing modifies it
+	std::map<std::string, FileInfo> parsedFileInfos;
+	std::unordered_map<std::string, UserTypeInfo> parsedTypeMap;
+	std::unordered_map<std::string, ExternalClassInfos> parsedExternalClassInfos;
+
+	if (checkDeterminism)
+	{
+		parsedFileInfos = outputFileInfos;
+		parsedTypeMap = cppToCsTypeMap;
+		parsedExternalClassInfos = externalClassInfos;
+	}
+
+	GeneratedFiles files;
+	postProcessFileInfos();
+
+	// Leave the previously generated files in place, rather than replacing them with incomplete output
+	if (!generateFiles(cppEngineOutputFolder, cppEditorOutputFolder, csEngineOutputFolder, csEditorOutputFolder, 
+		genEditor, files))
+	{
+		outs() << "Error: Code generation failed, no files were written.\n";
+		return false;
+	}
+
+	// Run post-processing and generation again from the parsed information, and make sure the output is identical
+	bool deterministic = true;
+	if (checkDeterminism)
+	{
+		outputFileInfos = std::move(parsedFileInfos);
+		cppToCsTypeMap = std::move(parsedTypeMap);
+		externalClassInfos = std::move(parsedExternalClassInfos);
+		classHierarchy = ClassHierarchy();
+
+		GeneratedFiles checkFiles;
+		postProcessFileInfos();
+		generateFiles(cppEngineOutputFolder, cppEditorOutputFolder, csEngineOutputFolder, csEditorOutputFolder, genEditor,
+			checkFiles);
+
+		deterministic = compareGeneratedFiles(files, checkFiles);
+	}
+
+	cleanAndPrepareFolder(cppEngineOutputFolder);
+	cleanAndPrepareFolder(csEngineOutputFolder);
 
 	if(genEditor)
-		generateMappingXMLFile(true, csEditorOutputFolder);
+	{
+		cleanAndPrepareFolder(cppEditorOutputFolder);
+		cleanAndPrepareFolder(csEditorOutputFolder);
+	}
+
+	writeGeneratedFiles(files);
+	return deterministic;
 }
@@ -21,15 +21,29 @@ std::string sEditorCopyrightNotice =
 	"//********************************** Banshee Engine (www.banshee3d.com) **************************************************//\n" \
 	"//************** Copyright (c) 2016-2019 Marko Pintera (marko.pintera@gmail.com). All rights reserved. *******************//\n";
 
+bool sReportIncludes = false;
+int sNumSourceShards = 0;
+int sUnityBuildSize = 0;
+std::vector<std::string> sUnityExcludedModules;
+bool sGenerateBinaryInfo = false;
+bool sDryRun = false;
+bool sGenerateCallBenchmark = false;
+bool sPoolWrapperAllocations = false;
+bool sLazyRuntimeData = false;
+std::string sCostReportPath;
+std::string sCostBaselinePath;
+
 std::unordered_map<std::string, UserTypeInfo> cppToCsTypeMap;
-std::unordered_map<std::string, FileInfo> outputFileInfos;
+std::map<std::string, FileInfo> outputFileInfos;
 std::unordered_map<std::string, ExternalClassInfos> externalClassInfos;
-std::unordered_map<std::string, BaseClassInfo> baseClassLookup;
+ClassHierarchy classHierarchy;
 
 std::vector<CommentInfo> commentInfos;
 std::unordered_map<std::string, int> commentFullLookup;
 std::unordered_map<std::string, SmallVector<int, 2>> commentSimpleLookup;
 
+thread_local raw_ostream* sTypeMappingLog = nullptr;
+
 static cl::OptionCategory OptCategory("Script binding options");
 static cl::extrahelp CommonHelp(CommonOptionsParser::HelpMessage);
 static cl::extrahelp CustomHelp("\nAdd \"-- <compiler arguments>\" at the end to setup the compiler "
@@ -60,6 +74,77 @@ static cl::opt<bool> GenerateEditorOption(
 	cl::desc("If enabled the script code marked with BED API will be generated as well.\n"),
 	cl::cat(OptCategory));
 
+static cl::opt<bool> CheckDeterminismOption(
+	"check-determinism",
+	cl::desc("If enabled the code will be generated twice and an error reported if the outputs are not identical.\n"),
+	cl::cat(OptCategory));
+
+static cl::opt<bool> ReportIncludesOption(
+	"report-includes",
+	cl::desc("If enabled a report of includes referenced by the generated files will be output.\n"),
+	cl::cat(OptCategory));
+
+static cl::opt<int> SourceShardsOption(
+	"cpp-shards",
+	cl::desc("If set to a non-zero value, generated C++ sources will be regrouped into the specified number of source " 
+		"files of similar compile cost, instead of one source file per exported file.\n"),
+	cl::init(0),
+	cl::cat(OptCategory));
+
+static cl::opt<int> UnityBuildSizeOption(
+	"unity-size",
+	cl::desc("If set to a non-zero value, generated C++ sources will be bundled into unity sources, each containing the "
+		"code of the specified number of exported files.\n"),
+	cl::init(0),
+	cl::cat(OptCategory));
+
+static cl::list<std::string> UnityExcludedModulesOption(
+	"unity-exclude-modules",
+	cl::desc("Specify a comma separated list of modules whose C++ sources will be generated one per exported file, even "
+		"if unity sources are enabled.\n"),
+	cl::CommaSeparated,
+	cl::cat(OptCategory));
+
+static cl::opt<bool> GenerateBinaryInfoOption(
+	"gen-binary-info",
+	cl::desc("If enabled a binary version of info.xml will be generated as well, in a format that can be memory mapped.\n"),
+	cl::cat(OptCategory));
+
+static cl::opt<bool> GenerateCallBenchmarkOption(
+	"gen-call-benchmark",
+	cl::desc("If enabled a micro-benchmark comparing the call overhead of methods forwarded directly to native code, "
+		"against the generic conversion path, will be generated.\n"),
+	cl::cat(OptCategory));
+
+static cl::opt<bool> LazyRuntimeDataOption(
+	"lazy-runtime-data",
+	cl::desc("If enabled the managed thunks used for triggering events will be resolved on first event trigger, instead "
+		"of when the runtime data is initialized. Internal calls are still registered on initialization.\n"),
+	cl::cat(OptCategory));
+
+static cl::opt<bool> PoolWrappersOption(
+	"pool-wrappers",
+	cl::desc("If enabled interop wrapper objects for plain classes will be allocated from per-type pool allocators, "
+		"instead of the general purpose heap.\n"),
+	cl::cat(OptCategory));
+
+static cl::opt<bool> DryRunOption(
+	"dry-run",
+	cl::desc("If enabled no files will be generated. Instead a report of the size and complexity of the code that would "
+		"be generated will be output.\n"),
+	cl::cat(OptCategory));
+
+static cl::opt<std::string> CostReportOption(
+	"cost-report",
+	cl::desc("Specify a file to save the dry run report to, so it can later be used as a baseline.\n"),
+	cl::cat(OptCategory));
+
+static cl::opt<std::string> CostBaselineOption(
+	"cost-baseline",
+	cl::desc("Specify a previously saved dry run report to compare the current report against. Significant growth of the "
+		"generated code is reported as an error.\n"),
+	cl::cat(OptCategory));
+
 static cl::opt<std::string> CppFrameworkNamespaceOption(
 	"cpp-framework-ns",
 	cl::desc("Specify namespace to place generated C++ framework types.\n"),
@@ -159,6 +244,24 @@ int main(int argc, const char** argv)
 	if (!CppEditorCopyrightNoticeOption.empty())
 		sEditorCopyrightNotice = std::string(CppEditorCopyrightNoticeOption.getValue().c_str());
 	
+	sReportIncludes = ReportIncludesOption.getValue();
+	sNumSourceShards = std::max(SourceShardsOption.getValue(), 0);
+	sUnityBuildSize = std::max(UnityBuildSizeOption.getValue(), 0);
+	sGenerateBinaryInfo = GenerateBinaryInfoOption.getValue();
+	sDryRun = DryRunOption.getValue();
+	sGenerateCallBenchmark = GenerateCallBenchmarkOption.getValue();
+	sPoolWrapperAllocations = PoolWrappersOption.getValue();
+	sLazyRuntimeData = LazyRuntimeDataOption.getValue();
+	sCostReportPath = CostReportOption.getValue();
+	sCostBaselinePath = CostBaselineOption.getValue();
+	sUnityExcludedModules.assign(UnityExcludedModulesOption.begin(), UnityExcludedModulesOption.end());
+
+	if (sNumSourceShards > 0 && sUnityBuildSize > 0)
+	{
+		outs() << "Warning: Both source sharding and unity sources are enabled. Ignoring the unity source options.\n";
+		sUnityBuildSize = 0;
+	}
+
 	// Note: I could auto-generate C++ wrappers for these types
 	SmallVector<std::string, 4> frameworkNs = { sFrameworkCppNs };
 	
@@ -192,12 +295,16 @@ int main(int argc, const char** argv)
 	bool genEditor = GenerateEditorOption.getValue();
 
 	// Generate code
-	generateAll(
+	bool checksPassed = generateAll(
 		OutputCppEngineOption.getValue(), 
 		OutputCppEditorOption.getValue(),
 		OutputCSEngineOption.getValue(),
 		OutputCSEditorOption.getValue(),
-		genEditor);
+		genEditor,
+		CheckDeterminismOption.getValue());
+
+	if (!checksPassed && output == 0)
+		output = 1;
 
 	//system("pause");
 	return output;
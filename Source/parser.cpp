@@ -1,4 +1,5 @@
 #include "parser.h"
+#include "clang/AST/RecordLayout.h"
 #include <cctype>
 
 ParsedType getObjectType(const CXXRecordDecl* decl)
@@ -731,6 +732,36 @@ void parseAttributeToken(const std::string& name, const std::string& value, Stri
 				sourceName << "\".\n";
 		}
 	}
+	else if (name == "batch")
+	{
+		if (value == "true")
+			output.exportFlags |= (int)ExportFlags::Batched;
+		else if (value != "false")
+		{
+			outs() << "Warning: Unrecognized value for \"batch\" option: \"" + value + "\" for type \"" <<
+				sourceName << "\".\n";
+		}
+	}
+	else if (name == "deferred")
+	{
+		if (value == "true")
+			output.exportFlags |= (int)ExportFlags::Deferred;
+		else if (value != "false")
+		{
+			outs() << "Warning: Unrecognized value for \"deferred\" option: \"" + value + "\" for type \"" <<
+				sourceName << "\".\n";
+		}
+	}
+	else if (name == "coalesce")
+	{
+		if (value == "true")
+			output.exportFlags |= (int)ExportFlags::Deferred | (int)ExportFlags::Coalesced;
+		else if (value != "false")
+		{
+			outs() << "Warning: Unrecognized value for \"coalesce\" option: \"" + value + "\" for type \"" <<
+				sourceName << "\".\n";
+		}
+	}
 	else if (name == "m")
 		output.moduleName = value;
 	else if (name == "hide")
@@ -1004,6 +1035,12 @@ bool parseParamOrFieldAttribute(Decl* decl, bool isField, int& typeFlags)
 			return true;
 		}
 
+		if (!isField && entry->getAnnotation() == "span")
+		{
+			typeFlags |= (int)TypeFlags::Span;
+			return true;
+		}
+
 		if (entry->getAnnotation() == "norref")
 		{
 			typeFlags &= ~(int)TypeFlags::AsResourceRef;
@@ -1877,6 +1914,12 @@ bool ScriptExportParser::parseEvent(ValueDecl* decl, const std::string& classNam
 	if (isCallback)
 		eventFlags |= (int)MethodFlags::Callback;
 
+	if ((parsedEventInfo.exportFlags & (int)ExportFlags::Deferred))
+		eventFlags |= (int)MethodFlags::Deferred;
+
+	if ((parsedEventInfo.exportFlags & (int)ExportFlags::Coalesced))
+		eventFlags |= (int)MethodFlags::Coalesced;
+
 	eventInfo.sourceName = sourceFieldName;
 	eventInfo.scriptName = parsedEventInfo.exportName;
 	eventInfo.flags = eventFlags;
@@ -2132,6 +2175,7 @@ bool ScriptExportParser::VisitCXXRecordDecl(CXXRecordDecl* decl)
 		structInfo.requiresInterop = decl->isPolymorphic();
 		structInfo.module = parsedClassInfo.moduleName;
 		structInfo.isTemplateInst = specDecl != nullptr;
+		structInfo.isStruct = decl->isStruct();
 		structInfo.templParams = templParams;
 		structInfo.api = apiFromExportFlags(parsedClassInfo.exportFlags);
 
@@ -2415,6 +2459,17 @@ bool ScriptExportParser::VisitCXXRecordDecl(CXXRecordDecl* decl)
 
 				parseParamOrFieldAttribute(fieldDecl, true, fieldInfo.flags);
 
+				// Record the native layout, so the generator can copy runs of layout compatible fields in bulk
+				if (curDecl == decl && decl->isStandardLayout() && !fieldDecl->isBitField())
+				{
+					const ASTRecordLayout& layout = astContext->getASTRecordLayout(curDecl);
+					uint64_t offsetBits = layout.getFieldOffset(fieldDecl->getFieldIndex());
+
+					fieldInfo.offset = (int)astContext->toCharUnitsFromBits(offsetBits).getQuantity();
+					fieldInfo.size = (int)astContext->getTypeSizeInChars(fieldDecl->getType()).getQuantity();
+					fieldInfo.alignment = (int)astContext->getTypeAlignInChars(fieldDecl->getType()).getQuantity();
+				}
+
 				// Remove the pass-as-resource-ref flag to all parameters initializing the field
 				if(!getPassAsResourceRef(fieldInfo.flags))
 				{
@@ -2628,6 +2683,9 @@ bool ScriptExportParser::VisitCXXRecordDecl(CXXRecordDecl* decl)
 				if ((parsedMethodInfo.exportFlags & (int)ExportFlags::InteropOnly))
 					methodFlags |= (int)MethodFlags::InteropOnly;
 
+				if ((parsedMethodInfo.exportFlags & (int)ExportFlags::Batched))
+					methodFlags |= (int)MethodFlags::Batched;
+
 				bool isStatic = false;
 				if (methodDecl->isStatic() && !isExternal) // Note: Perhaps add a way to mark external methods as static
 				{